@@ -0,0 +1,113 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Compares next-hop extraction by walking the predecessors back from every target
+// with first-hop labels carried forward during the search, for all-pairs routing
+// on random airspace graphs.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "BitGraph.h"
+#include "SpatialGrid.h"
+
+struct Position {
+    double x, y, z;
+};
+
+static AdjacencyLists buildRandomGraph(int numNodes, double range, double meanDegree, unsigned seed)
+{
+    // Square airspace sized so that a node has meanDegree neighbors on average
+    double side = std::sqrt(numNodes * M_PI * range * range / meanDegree);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> horizontal(0, side);
+    std::uniform_real_distribution<double> altitude(9000, 12000);
+    std::vector<Position> positions(numNodes);
+    for (auto& p : positions)
+        p = { horizontal(rng), horizontal(rng), altitude(rng) };
+
+    std::vector<std::vector<std::pair<int, uint16_t>>> rows(numNodes);
+    SpatialGrid<Position> grid(positions, range);
+    grid.forEachCandidatePair([&](int i, int j) {
+        double dx = positions[i].x - positions[j].x;
+        double dy = positions[i].y - positions[j].y;
+        double dz = positions[i].z - positions[j].z;
+        if (std::sqrt(dx * dx + dy * dy + dz * dz) <= range) {
+            rows[i].push_back({ j, 1 });
+            rows[j].push_back({ i, 1 });
+        }
+    });
+    for (auto& row : rows)
+        std::sort(row.begin(), row.end());
+    AdjacencyLists links;
+    links.assign(rows);
+    return links;
+}
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    const double range = 200000;
+    const double meanDegree = 16;
+    const int sizes[] = { 500, 2000, 5000 };
+
+    printf("%8s %14s %14s %14s %10s\n", "N", "walk-back ms", "first-hop ms", "removed ms", "checksum");
+    for (int numNodes : sizes) {
+        BitGraph graph;
+        graph.assign(buildRandomGraph(numNodes, range, meanDegree, 42));
+        std::vector<int> dist, previous, firstHop, nextHops(numNodes);
+        long checksumWalkBack = 0, checksumFirstHop = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int src = 0; src < numNodes; ++src) {
+            graph.search(src, dist, previous);
+            for (int i = 0; i < numNodes; i++) {
+                nextHops[i] = -1;
+                if (i == src)
+                    nextHops[i] = i;
+                else if (previous[i] != -1) {
+                    int nextHop = i;
+                    while (previous[nextHop] != src && previous[nextHop] != -1)
+                        nextHop = previous[nextHop];
+                    nextHops[i] = nextHop;
+                }
+                checksumWalkBack += nextHops[i];
+            }
+        }
+        double walkBackMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int src = 0; src < numNodes; ++src) {
+            graph.search(src, dist, previous, &firstHop);
+            for (int i = 0; i < numNodes; i++) {
+                nextHops[i] = firstHop[i];
+                checksumFirstHop += nextHops[i];
+            }
+        }
+        double firstHopMs = elapsedMs(start);
+
+        printf("%8d %14.1f %14.1f %14.1f %10s\n", numNodes, walkBackMs, firstHopMs, walkBackMs - firstHopMs,
+                checksumWalkBack == checksumFirstHop ? "match" : "MISMATCH");
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Checks that packets for ground stations reach the ground without bouncing between a ground station and the
+// aircraft around it, following the same next hop choice as NodeManager::findNextHop.
+//
+// Usage: ground_station_check
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "RouteCalculator.h"
+
+static const double communicationRange = 200000;
+static const double groundStationRange = 370400;
+
+struct Tables {
+    std::vector<bool> isDestination;
+    std::vector<uint16_t> nearestDestination;
+    DijkstraAllPairsOutput allPairs;
+    DijkstraAllPairsOutput toDestinations;
+};
+
+static Tables routeTables(const std::vector<Position>& positions, const std::vector<int>& destIndices)
+{
+    ThreadPool threadPool(1);
+    RouteCalculator routes(&threadPool);
+    routes.communicationRange = communicationRange;
+    routes.groundStationRange = groundStationRange;
+    AdjacencyLists links = routes.buildGraph(positions, destIndices);
+    BitGraph graph;
+    graph.assign(links);
+    routes.setGraph(std::move(graph), links, destIndices);
+    Tables tables;
+    tables.isDestination.assign(positions.size(), false);
+    for (int destIdx : destIndices)
+        tables.isDestination[destIdx] = true;
+    tables.allPairs = routes.findAllShortestPaths();
+    tables.toDestinations = routes.findAllShortestPathsToDestination(destIndices, tables.nearestDestination);
+    return tables;
+}
+
+// Hops from src to the ground station dest, -1 if the packet is dropped for lack of a route, -2 if it loops
+static int forward(const Tables& tables, int src, int dest)
+{
+    int numNodes = tables.isDestination.size();
+    int at = src;
+    for (int hops = 0; hops <= numNodes; ++hops) {
+        if (at == dest)
+            return hops;
+        at = RouteCalculator::routesToNearestDestination(at, dest, tables.isDestination, tables.nearestDestination)
+                ? tables.toDestinations.nextHop(at, 0) : tables.allPairs.nextHop(at, dest);
+        if (at < 0)
+            return -1;
+    }
+    return -2;
+}
+
+// Every node sends to every ground station, both to the station the packet names and, for aircraft, to the nearest
+// one that Dspr rewrites the destination to. Named stations that are not the nearest stand for packets whose
+// rewritten destination went stale with a route update, and for packets already on the ground at another station.
+static int check(const char *name, const std::vector<Position>& positions, const std::vector<int>& destIndices)
+{
+    Tables tables = routeTables(positions, destIndices);
+    int numNodes = positions.size();
+    int numRoutes = 0;
+    for (int src = 0; src < numNodes; ++src) {
+        std::vector<int> dests(destIndices);
+        if (!tables.isDestination[src] && tables.nearestDestination[src] != UNREACHABLE_ROUTE)
+            dests.push_back(tables.nearestDestination[src]);
+        for (int dest : dests) {
+            if (dest == src)
+                continue;
+            int hops = forward(tables, src, dest);
+            int distance = tables.allPairs.distance(src, dest);
+            bool reachable = distance != INT_MAX;
+            if (hops == -2 || (hops == -1) == reachable || (hops >= 0 && hops != distance)) {
+                printf("%s: FAILED from node %d to ground station %d: %s, shortest route %d hops\n", name, src, dest,
+                        hops == -2 ? "loops" : hops == -1 ? "dropped" : "longer route", reachable ? distance : -1);
+                return 1;
+            }
+            ++numRoutes;
+        }
+    }
+    printf("%s: ok, %d routes to ground stations\n", name, numRoutes);
+    return 0;
+}
+
+int main()
+{
+    // Two ground stations 1000 km apart with a chain of aircraft between them: every aircraft is nearer to one
+    // station, and packets for the other must pass over it instead of landing at the nearer one
+    std::vector<Position> positions;
+    for (int i = 0; i < 7; ++i)
+        positions.push_back({ 50000 + i * 150000.0, 0, 10000 });
+    std::vector<int> destIndices = { 7, 8 };
+    positions.push_back({ 0, 0, 0 });
+    positions.push_back({ 1000000, 0, 0 });
+    int failures = check("two ground stations", positions, destIndices);
+
+    // Random airspaces with two to five ground stations
+    std::mt19937 rng(42);
+    for (int trial = 0; trial < 20; ++trial) {
+        int numAircraft = 50 + rng() % 250;
+        int numGroundStations = 2 + rng() % 4;
+        double side = std::sqrt(numAircraft * M_PI * communicationRange * communicationRange / 8);
+        std::uniform_real_distribution<double> horizontal(0, side);
+        std::uniform_real_distribution<double> altitude(9000, 12000);
+        positions.clear();
+        destIndices.clear();
+        for (int i = 0; i < numAircraft; ++i)
+            positions.push_back({ horizontal(rng), horizontal(rng), altitude(rng) });
+        for (int i = 0; i < numGroundStations; ++i) {
+            destIndices.push_back(positions.size());
+            positions.push_back({ horizontal(rng), horizontal(rng), 0 });
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "random airspace %d", trial);
+        failures += check(name, positions, destIndices);
+    }
+    return failures > 0 ? 1 : 0;
+}
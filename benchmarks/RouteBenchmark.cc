@@ -0,0 +1,194 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Times each phase of a route update on synthetic airspace scenarios and reports the memory
+// held by its result, using the same RouteCalculator as NodeManager.
+//
+// Usage: route_benchmark [maxNodes [numThreads [backupRoutes [routeEngine [pruneComponents]]]]]
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include "RouteCalculator.h"
+#include "RouteEngine.h"
+
+static const double communicationRange = 200000;
+static const double groundStationRange = 370400;
+static const double meanDegree = 16;
+
+struct Scenario {
+    std::vector<Position> positions; // aircraft first, then ground stations
+    std::vector<int> destIndices;
+};
+
+static Position aircraft(double x, double y, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> altitude(9000, 12000);
+    return { x, y, altitude(rng) };
+}
+
+static void addGroundStation(Scenario& scenario, double x, double y)
+{
+    scenario.destIndices.push_back(scenario.positions.size());
+    scenario.positions.push_back({ x, y, 0 });
+}
+
+// Continental airspace: aircraft spread evenly over a square sized for meanDegree neighbors,
+// with a ground station for every hundred aircraft
+static Scenario uniformScenario(int numNodes, unsigned seed)
+{
+    Scenario scenario;
+    std::mt19937 rng(seed);
+    double side = std::sqrt(numNodes * M_PI * communicationRange * communicationRange / meanDegree);
+    std::uniform_real_distribution<double> horizontal(0, side);
+    int numGroundStations = std::max(1, numNodes / 100);
+    for (int i = 0; i < numNodes - numGroundStations; ++i)
+        scenario.positions.push_back(aircraft(horizontal(rng), horizontal(rng), rng));
+    for (int i = 0; i < numGroundStations; ++i)
+        addGroundStation(scenario, horizontal(rng), horizontal(rng));
+    return scenario;
+}
+
+// Oceanic track system: a 300 km wide corridor at the same density, with ground stations only at both ends
+static Scenario corridorScenario(int numNodes, unsigned seed)
+{
+    Scenario scenario;
+    std::mt19937 rng(seed);
+    double width = 300000;
+    double length = numNodes * M_PI * communicationRange * communicationRange / meanDegree / width;
+    std::uniform_real_distribution<double> along(0, length);
+    std::uniform_real_distribution<double> across(0, width);
+    for (int i = 0; i < numNodes - 2; ++i)
+        scenario.positions.push_back(aircraft(along(rng), across(rng), rng));
+    addGroundStation(scenario, 0, width / 2);
+    addGroundStation(scenario, length, width / 2);
+    return scenario;
+}
+
+// Hub airports: four fifths of the aircraft in clusters around five hubs, which also host the ground stations,
+// the rest spread over the same area as in the uniform scenario
+static Scenario hubScenario(int numNodes, unsigned seed)
+{
+    Scenario scenario;
+    std::mt19937 rng(seed);
+    double side = std::sqrt(numNodes * M_PI * communicationRange * communicationRange / meanDegree);
+    std::uniform_real_distribution<double> horizontal(0, side);
+    std::normal_distribution<double> cluster(0, 100000);
+    const int numHubs = 5;
+    std::vector<Position> hubs;
+    for (int h = 0; h < numHubs; ++h)
+        hubs.push_back({ horizontal(rng), horizontal(rng), 0 });
+    int numAircraft = numNodes - numHubs;
+    for (int i = 0; i < numAircraft; ++i) {
+        if (i < numAircraft * 4 / 5) {
+            const Position& hub = hubs[i % numHubs];
+            scenario.positions.push_back(aircraft(hub.x + cluster(rng), hub.y + cluster(rng), rng));
+        }
+        else
+            scenario.positions.push_back(aircraft(horizontal(rng), horizontal(rng), rng));
+    }
+    for (const Position& hub : hubs)
+        addGroundStation(scenario, hub.x, hub.y);
+    return scenario;
+}
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double megabytes(size_t bytes)
+{
+    return bytes / (1024.0 * 1024.0);
+}
+
+static double peakResidentMegabytes()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0; // kilobytes on Linux
+}
+
+int main(int argc, char **argv)
+{
+    int maxNodes = argc > 1 ? std::atoi(argv[1]) : 10000;
+    int numThreads = argc > 2 ? std::atoi(argv[2]) : 1;
+    bool backupRoutes = argc > 3 ? std::atoi(argv[3]) != 0 : false; // NodeManager's default
+    std::string engineName = argc > 4 ? argv[4] : "search";
+    bool pruneComponents = argc > 5 ? std::atoi(argv[5]) != 0 : true;
+    std::unique_ptr<RouteEngine> engine(RouteEngine::create(engineName));
+    if (!engine) {
+        fprintf(stderr, "Unknown route engine '%s'\n", engineName.c_str());
+        return 1;
+    }
+    const int sizes[] = { 100, 300, 1000, 3000, 10000 };
+    typedef Scenario (*Generator)(int, unsigned);
+    const std::pair<const char *, Generator> scenarios[] = {
+        { "uniform", uniformScenario },
+        { "corridor", corridorScenario },
+        { "hub", hubScenario },
+    };
+
+    ThreadPool threadPool(numThreads);
+    printf("%s engine, %d threads, backup routes %s, component pruning %s, times in ms, memory in MiB held by the phase's result\n",
+            engine->getName(), threadPool.size(), backupRoutes ? "on" : "off", pruneComponents ? "on" : "off");
+    printf("%-9s %6s %8s | %9s %8s | %9s %8s | %9s %8s | %9s %8s | %8s\n", "scenario", "N", "links",
+            "build ms", "links", "assign ms", "graph", "all-pairs", "table", "dest ms", "table", "peak RSS");
+    for (const auto& scenario : scenarios) {
+        for (int numNodes : sizes) {
+            if (numNodes > maxNodes)
+                continue;
+            Scenario s = scenario.second(numNodes, 42);
+            RouteCalculator routes(&threadPool);
+            routes.communicationRange = communicationRange;
+            routes.groundStationRange = groundStationRange;
+            routes.backupRoutes = backupRoutes;
+            routes.pruneComponents = pruneComponents;
+            routes.setEngine(RouteEngine::create(engineName));
+
+            auto start = std::chrono::steady_clock::now();
+            AdjacencyLists links = routes.buildGraph(s.positions, s.destIndices);
+            double buildMs = elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            BitGraph graph;
+            graph.assign(links);
+            long numLinks = graph.numEdges();
+            routes.setGraph(std::move(graph), links, s.destIndices);
+            double assignMs = elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            DijkstraAllPairsOutput allPairs = routes.findAllShortestPaths();
+            double allPairsMs = elapsedMs(start);
+
+            start = std::chrono::steady_clock::now();
+            std::vector<uint16_t> nearestDestination;
+            DijkstraAllPairsOutput toDestinations = routes.findAllShortestPathsToDestination(s.destIndices, nearestDestination);
+            double destinationMs = elapsedMs(start);
+
+            printf("%-9s %6d %8ld | %9.1f %8.1f | %9.1f %8.2f | %9.1f %8.1f | %9.2f %8.3f | %8.1f\n", scenario.first, numNodes, numLinks,
+                    buildMs, megabytes(links.memoryBytes()), assignMs, megabytes(routes.graphMemoryBytes()),
+                    allPairsMs, megabytes(allPairs.memoryBytes()), destinationMs, megabytes(toDestinations.memoryBytes()), peakResidentMegabytes());
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,208 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+// Checks the route tables of the faster paths against a full search on a single thread, on random airspaces:
+// the same tables with more threads, the same distances from the Floyd-Warshall engine, and the same routes
+// after the incremental repair of NodeManager's incrementalRouteUpdates.
+//
+// Usage: route_check [numThreads]
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "RouteCalculator.h"
+#include "RouteEngine.h"
+#include "FloydWarshallRouteEngine.h"
+
+static const double communicationRange = 200000;
+static const double groundStationRange = 370400;
+
+struct Airspace {
+    std::vector<Position> positions; // aircraft first, then ground stations
+    std::vector<int> destIndices;
+};
+
+// Sparse enough that some aircraft lose contact with every ground station
+static Airspace randomAirspace(std::mt19937& rng)
+{
+    Airspace airspace;
+    int numAircraft = 50 + rng() % 350;
+    int numGroundStations = 1 + rng() % 4;
+    double side = std::sqrt(numAircraft * M_PI * communicationRange * communicationRange / 6);
+    std::uniform_real_distribution<double> horizontal(0, side);
+    std::uniform_real_distribution<double> altitude(9000, 12000);
+    for (int i = 0; i < numAircraft; ++i)
+        airspace.positions.push_back({ horizontal(rng), horizontal(rng), altitude(rng) });
+    for (int i = 0; i < numGroundStations; ++i) {
+        airspace.destIndices.push_back(airspace.positions.size());
+        airspace.positions.push_back({ horizontal(rng), horizontal(rng), 0 });
+    }
+    return airspace;
+}
+
+// Aircraft fly up to 30 km between route updates
+static void moveAircraft(Airspace& airspace, std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> step(-30000, 30000);
+    for (Position& p : airspace.positions) {
+        if (p.z > 0) {
+            p.x += step(rng);
+            p.y += step(rng);
+        }
+    }
+}
+
+static void assignGraph(RouteCalculator& routes, const Airspace& airspace)
+{
+    routes.communicationRange = communicationRange;
+    routes.groundStationRange = groundStationRange;
+    AdjacencyLists links = routes.buildGraph(airspace.positions, airspace.destIndices);
+    BitGraph graph;
+    graph.assign(links);
+    routes.setGraph(std::move(graph), links, airspace.destIndices);
+}
+
+static bool sameRows(const DijkstraAllPairsOutput& a, const DijkstraAllPairsOutput& b, int row, bool withBackups)
+{
+    int n = a.numColumns;
+    for (int col = 0; col < n; ++col) {
+        if (a.distance(row, col) != b.distance(row, col) || a.nextHop(row, col) != b.nextHop(row, col)
+                || (withBackups && a.backupNextHop(row, col) != b.backupNextHop(row, col)))
+            return false;
+    }
+    return true;
+}
+
+static int fail(const char *check, int trial, const char *what)
+{
+    printf("%s, airspace %d: FAILED, %s\n", check, trial, what);
+    return 1;
+}
+
+// Every table and the links themselves must not depend on the number of threads, for every link metric
+static int checkThreads(const Airspace& airspace, int trial, int numThreads, ThreadPool& singleThread)
+{
+    ThreadPool threadPool(numThreads);
+    RouteCalculator reference(&singleThread), parallel(&threadPool);
+    for (RouteCalculator *routes : { &reference, &parallel }) {
+        routes->linkMetric = (LinkMetric)(trial % 3);
+        routes->backupRoutes = true;
+        routes->pruneComponents = trial % 2 == 0;
+    }
+    AdjacencyLists referenceLinks = reference.buildGraph(airspace.positions, airspace.destIndices);
+    AdjacencyLists parallelLinks = parallel.buildGraph(airspace.positions, airspace.destIndices);
+    if (referenceLinks.offsets != parallelLinks.offsets || referenceLinks.targets != parallelLinks.targets || referenceLinks.weights != parallelLinks.weights)
+        return fail("threads", trial, "different links");
+    assignGraph(reference, airspace);
+    assignGraph(parallel, airspace);
+    DijkstraAllPairsOutput a = reference.findAllShortestPaths(), b = parallel.findAllShortestPaths();
+    if (a.distances != b.distances || a.nextHops != b.nextHops || a.backupNextHops != b.backupNextHops)
+        return fail("threads", trial, "different all-pairs tables");
+    std::vector<uint16_t> nearestA, nearestB;
+    a = reference.findAllShortestPathsToDestination(airspace.destIndices, nearestA);
+    b = parallel.findAllShortestPathsToDestination(airspace.destIndices, nearestB);
+    if (a.distances != b.distances || a.nextHops != b.nextHops || a.backupNextHops != b.backupNextHops || nearestA != nearestB)
+        return fail("threads", trial, "different routes to the ground stations");
+    return 0;
+}
+
+// Floyd-Warshall finds the same distances; its next hops may pick another neighbor on a shortest path
+static int checkFloydWarshall(const Airspace& airspace, int trial, int numThreads, ThreadPool& singleThread)
+{
+    ThreadPool threadPool(numThreads);
+    RouteCalculator reference(&singleThread), floydWarshall(&threadPool);
+    floydWarshall.setEngine(new FloydWarshallRouteEngine());
+    for (RouteCalculator *routes : { &reference, &floydWarshall }) {
+        routes->backupRoutes = true;
+        routes->pruneComponents = trial % 2 == 0;
+        assignGraph(*routes, airspace);
+    }
+    DijkstraAllPairsOutput a = reference.findAllShortestPaths(), b = floydWarshall.findAllShortestPaths();
+    if (a.distances != b.distances)
+        return fail("Floyd-Warshall", trial, "different distances");
+    const BitGraph& graph = reference.getGraph();
+    int numNodes = graph.size();
+    for (int src = 0; src < numNodes; ++src) {
+        for (int dest = 0; dest < numNodes; ++dest) {
+            int hop = b.nextHop(src, dest);
+            if (a.distance(src, dest) == INT_MAX || src == dest) {
+                if (hop != (src == dest ? src : -1))
+                    return fail("Floyd-Warshall", trial, "next hop without a route");
+                continue;
+            }
+            if (hop < 0 || !graph.hasEdge(src, hop) || b.distance(hop, dest) != b.distance(src, dest) - 1)
+                return fail("Floyd-Warshall", trial, "next hop off the shortest routes");
+            int backup = b.backupNextHop(src, dest);
+            if (backup >= 0 && (backup == hop || !graph.hasEdge(src, backup) || b.distance(backup, dest) > b.distance(src, dest)))
+                return fail("Floyd-Warshall", trial, "backup next hop that may loop");
+        }
+    }
+    return 0;
+}
+
+// Repairing only the affected rows after the aircraft moved gives the routes of a full recomputation
+static int checkIncremental(Airspace airspace, int trial, std::mt19937& rng, ThreadPool& singleThread)
+{
+    RouteCalculator routes(&singleThread);
+    routes.backupRoutes = true;
+    routes.pruneComponents = true;
+    assignGraph(routes, airspace);
+    DijkstraAllPairsOutput repaired = routes.findAllShortestPaths();
+    int numNodes = airspace.positions.size();
+    std::vector<bool> wasRoutedSource(numNodes);
+    for (int src = 0; src < numNodes; ++src)
+        wasRoutedSource[src] = routes.isRoutedSource(src);
+
+    moveAircraft(airspace, rng);
+    AdjacencyLists links = routes.buildGraph(airspace.positions, airspace.destIndices);
+    BitGraph graph;
+    graph.assign(links);
+    std::vector<std::pair<int, int>> changedEdges;
+    graph.diff(routes.getGraph(), changedEdges);
+    routes.setGraph(std::move(graph), links, airspace.destIndices);
+    DijkstraAllPairsOutput recomputed = routes.findAllShortestPaths();
+    for (int src = 0; src < numNodes; ++src) {
+        if (!routes.isRouteRowAffected(src, wasRoutedSource[src], repaired.distanceRow(src), changedEdges))
+            continue;
+        routes.findShortestPathsFromSource(src, repaired.distanceRow(src), repaired.nextHopRow(src), repaired.backupNextHopRow(src));
+    }
+    // Backup next hops of rows kept as they were may be outdated; NodeManager checks them against the current routes
+    for (int src = 0; src < numNodes; ++src) {
+        if (!sameRows(repaired, recomputed, src, false))
+            return fail("incremental", trial, "repaired routes differ from a full recomputation");
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int numThreads = argc > 1 ? std::atoi(argv[1]) : 4;
+    ThreadPool singleThread(1);
+    std::mt19937 rng(7);
+    int failures = 0;
+    const int numTrials = 30;
+    for (int trial = 0; trial < numTrials; ++trial) {
+        Airspace airspace = randomAirspace(rng);
+        failures += checkThreads(airspace, trial, numThreads, singleThread);
+        failures += checkFloydWarshall(airspace, trial, numThreads, singleThread);
+        failures += checkIncremental(airspace, trial, rng, singleThread);
+    }
+    printf("%d airspaces, %d threads: %s\n", numTrials, numThreads, failures > 0 ? "FAILED" : "ok");
+    return failures > 0 ? 1 : 0;
+}
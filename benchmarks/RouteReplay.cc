@@ -0,0 +1,140 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+// Replays the route updates recorded through NodeManager's positionRecordFile: every snapshot goes through
+// graph building and the route searches of RouteCalculator, without the rest of the simulation.
+//
+// Usage: route_replay file [routeEngine [numThreads [backupRoutes [pruneComponents]]]]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "PositionSnapshot.h"
+#include "RouteEngine.h"
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s file [routeEngine [numThreads [backupRoutes [pruneComponents]]]]\n", argv[0]);
+        return 1;
+    }
+    std::string engineName = argc > 2 ? argv[2] : "search";
+    int numThreads = argc > 3 ? std::atoi(argv[3]) : 1;
+    bool backupRoutes = argc > 4 ? std::atoi(argv[4]) != 0 : false;
+    bool pruneComponents = argc > 5 ? std::atoi(argv[5]) != 0 : true;
+
+    int fd = open(argv[1], O_RDONLY);
+    struct stat status;
+    if (fd < 0 || fstat(fd, &status) < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    size_t fileSize = status.st_size;
+    if (fileSize < sizeof(PositionSnapshotFileHeader)) {
+        fprintf(stderr, "%s: not a position snapshot file\n", argv[1]);
+        return 1;
+    }
+    const char *data = (const char *)mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+    const PositionSnapshotFileHeader *fileHeader = (const PositionSnapshotFileHeader *)data;
+    if (memcmp(fileHeader->magic, POSITION_SNAPSHOT_MAGIC, sizeof(fileHeader->magic)) != 0
+            || fileHeader->version != POSITION_SNAPSHOT_VERSION || fileHeader->snapshotHeaderSize != sizeof(PositionSnapshotHeader)) {
+        fprintf(stderr, "%s: not a version %u position snapshot file\n", argv[1], POSITION_SNAPSHOT_VERSION);
+        return 1;
+    }
+
+    ThreadPool threadPool(numThreads);
+    RouteCalculator routes(&threadPool);
+    RouteEngine *engine = RouteEngine::create(engineName);
+    if (!engine) {
+        fprintf(stderr, "Unknown route engine '%s'\n", engineName.c_str());
+        return 1;
+    }
+    routes.setEngine(engine);
+    routes.backupRoutes = backupRoutes;
+    routes.pruneComponents = pruneComponents;
+
+    printf("%s engine, %d threads, backup routes %s, component pruning %s, times in ms\n",
+            engine->getName(), threadPool.size(), backupRoutes ? "on" : "off", pruneComponents ? "on" : "off");
+    printf("%10s %6s %8s | %9s %9s %9s %9s\n", "sim time", "N", "links", "build", "assign", "all-pairs", "dest");
+    int numSnapshots = 0;
+    double totalMs[4] = {};
+    std::vector<Position> positions;
+    std::vector<int> destIndices;
+    for (size_t offset = sizeof(PositionSnapshotFileHeader); offset + sizeof(PositionSnapshotHeader) <= fileSize; ) {
+        const PositionSnapshotHeader *header = (const PositionSnapshotHeader *)(data + offset);
+        size_t size = positionSnapshotSize(*header);
+        if (offset + size > fileSize) {
+            fprintf(stderr, "Truncated snapshot at offset %zu ignored\n", offset);
+            break;
+        }
+        const Position *position = (const Position *)(header + 1);
+        const int32_t *destIndex = (const int32_t *)((const uint32_t *)(position + header->numNodes) + header->numNodes);
+        positions.assign(position, position + header->numNodes);
+        destIndices.assign(destIndex, destIndex + header->numDestinations);
+        offset += size;
+        if (!engine->supportsLinkMetric((LinkMetric)header->linkMetric)) {
+            fprintf(stderr, "Snapshot at %.3f s skipped: engine does not support its link metric\n", header->simTime);
+            continue;
+        }
+        routes.communicationRange = header->communicationRange;
+        routes.groundStationRange = header->groundStationRange;
+        routes.linkMetric = (LinkMetric)header->linkMetric;
+        routes.linkWeightLevels = header->linkWeightLevels;
+
+        double ms[4];
+        auto start = std::chrono::steady_clock::now();
+        AdjacencyLists links = routes.buildGraph(positions, destIndices);
+        ms[0] = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        BitGraph graph;
+        graph.assign(links);
+        long numLinks = graph.numEdges();
+        routes.setGraph(std::move(graph), links, destIndices);
+        ms[1] = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        DijkstraAllPairsOutput allPairs = routes.findAllShortestPaths();
+        ms[2] = elapsedMs(start);
+        start = std::chrono::steady_clock::now();
+        std::vector<uint16_t> nearestDestination;
+        DijkstraAllPairsOutput toDestinations = routes.findAllShortestPathsToDestination(destIndices, nearestDestination);
+        ms[3] = elapsedMs(start);
+
+        printf("%10.3f %6u %8ld | %9.2f %9.2f %9.2f %9.2f\n", header->simTime, header->numNodes, numLinks, ms[0], ms[1], ms[2], ms[3]);
+        for (int phase = 0; phase < 4; ++phase)
+            totalMs[phase] += ms[phase];
+        ++numSnapshots;
+    }
+    printf("%10s %6d %8s | %9.1f %9.1f %9.1f %9.1f\n", "total", numSnapshots, "", totalMs[0], totalMs[1], totalMs[2], totalMs[3]);
+    munmap((void *)data, fileSize);
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+# The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+# Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+
+# You should have received a copy of the GNU Lesser General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+"""Reader for the route table snapshots written through NodeManager's routeTableSnapshotFile.
+
+The layout is described in src/RouteTableSnapshot.h. Columns are returned as memoryviews
+into the memory-mapped file, so numpy.asarray(column) gives an array without copying:
+
+    for epoch in read_route_tables("routes.bin"):
+        next_hops = numpy.asarray(epoch.next_hops).reshape(epoch.num_nodes, epoch.num_nodes)
+
+With lazyRouteComputation only the sources that forwarded packets during an epoch have an all-pairs
+row; computed_rows tells which, and the rows of all other sources hold UNREACHABLE_ROUTE.
+
+Run as a script to print a summary of every epoch.
+"""
+
+import ipaddress
+import mmap
+import struct
+import sys
+
+MAGIC = b"DSPRRTS\0"
+VERSION = 2
+UNREACHABLE_ROUTE = 0xFFFF
+ALL_PAIRS = 1
+BACKUPS = 2
+
+_FILE_HEADER = struct.Struct("=8sII")
+_HEADER = struct.Struct("=dqIIII")
+
+
+class RouteEpoch:
+    """Topology and route tables of one route epoch; node indices refer to addresses."""
+
+    def __init__(self, sim_time, route_epoch, num_nodes, num_links, flags):
+        self.sim_time = sim_time
+        self.route_epoch = route_epoch
+        self.num_nodes = num_nodes
+        self.num_links = num_links
+        self.flags = flags
+        self.addresses = None  # IPv4 addresses as integers, 0 for other address types
+        self.link_sources = None
+        self.link_targets = None
+        self.nearest_destination = None
+        self.destination_next_hops = None
+        self.destination_distances = None
+        self.computed_rows = None  # 1 for sources whose all-pairs row belongs to this epoch, None without ALL_PAIRS
+        self.distances = None  # row-major numNodes x numNodes, None without ALL_PAIRS; rows not computed are unreachable
+        self.next_hops = None
+        self.backup_next_hops = None  # None without BACKUPS
+
+    def address(self, index):
+        return str(ipaddress.IPv4Address(self.addresses[index]))
+
+    def next_hop(self, source, destination):
+        """Next hop index of the all-pairs table, None if unreachable or if the row of source was not computed."""
+        hop = self.next_hops[source * self.num_nodes + destination]
+        return None if hop == UNREACHABLE_ROUTE else hop
+
+
+def read_route_tables(path):
+    """Yields a RouteEpoch for every snapshot in the file."""
+    with open(path, "rb") as f:
+        data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    view = memoryview(data)
+    magic, version, header_size = _FILE_HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION or header_size != _HEADER.size:
+        raise ValueError("%s is not a version %d route table snapshot file" % (path, VERSION))
+    offset = _FILE_HEADER.size
+
+    def column(count, item_size, code):
+        nonlocal offset
+        size = count * item_size
+        if offset + size > len(data):
+            raise ValueError("%s is truncated" % path)
+        values = view[offset:offset + size].cast(code)
+        offset += (size + 7) & ~7
+        return values
+
+    while offset + _HEADER.size <= len(data):
+        epoch = RouteEpoch(*_HEADER.unpack_from(data, offset)[:5])
+        offset += _HEADER.size
+        n = epoch.num_nodes
+        epoch.addresses = column(n, 4, "I")
+        epoch.link_sources = column(epoch.num_links, 2, "H")
+        epoch.link_targets = column(epoch.num_links, 2, "H")
+        epoch.nearest_destination = column(n, 2, "H")
+        epoch.destination_next_hops = column(n, 2, "H")
+        epoch.destination_distances = column(n, 2, "H")
+        if epoch.flags & ALL_PAIRS:
+            epoch.computed_rows = column(n, 1, "B")
+            epoch.distances = column(n * n, 2, "H")
+            epoch.next_hops = column(n * n, 2, "H")
+        if epoch.flags & BACKUPS:
+            epoch.backup_next_hops = column(n * n, 2, "H")
+        yield epoch
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit("Usage: %s file" % sys.argv[0])
+    print("%10s %8s %6s %8s %12s %12s" % ("sim time", "epoch", "N", "links", "to GS", "mean GS hops"))
+    for epoch in read_route_tables(sys.argv[1]):
+        hops = [d for d in epoch.destination_distances if d != UNREACHABLE_ROUTE]
+        print("%10.3f %8d %6d %8d %12d %12.2f" % (epoch.sim_time, epoch.route_epoch, epoch.num_nodes, epoch.num_links,
+                                                   len(hops), sum(hops) / len(hops) if hops else 0))
+
+
+if __name__ == "__main__":
+    main()
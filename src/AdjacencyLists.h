@@ -0,0 +1,54 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+
+#ifndef ADJACENCYLISTS_H_
+#define ADJACENCYLISTS_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Links of a graph in compressed sparse rows, as built from the positions of a route update.
+// Links are symmetric, so every link appears in the rows of both of its nodes.
+struct AdjacencyLists {
+    std::vector<int> offsets; // links of u are [offsets[u], offsets[u + 1])
+    std::vector<int> targets; // ascending within each row
+    std::vector<uint16_t> weights; // positive link weights alongside targets
+
+    int size() const { return offsets.empty() ? 0 : (int)offsets.size() - 1; }
+    size_t memoryBytes() const { return (offsets.capacity() + targets.capacity()) * sizeof(int) + weights.capacity() * sizeof(uint16_t); }
+
+    // Compresses one list of (neighbor, weight) per node; each list must already be sorted by neighbor
+    void assign(const std::vector<std::vector<std::pair<int, uint16_t>>>& rows) {
+        int numNodes = rows.size();
+        offsets.assign(numNodes + 1, 0);
+        for (int u = 0; u < numNodes; ++u)
+            offsets[u + 1] = offsets[u] + rows[u].size();
+        targets.resize(offsets[numNodes]);
+        weights.resize(offsets[numNodes]);
+        for (int u = 0; u < numNodes; ++u) {
+            int k = offsets[u];
+            for (const auto& link : rows[u]) {
+                targets[k] = link.first;
+                weights[k++] = link.second;
+            }
+        }
+    }
+};
+
+#endif /* ADJACENCYLISTS_H_ */
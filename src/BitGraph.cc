@@ -0,0 +1,230 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <climits>
+#include <algorithm>
+#include "BitGraph.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+void BitGraph::assign(const AdjacencyLists& links)
+{
+    numNodes = links.size();
+    wordsPerRow = ((numNodes + 255) / 256) * 4;
+    rows.assign((size_t)numNodes * wordsPerRow, 0);
+    neighborStart = links.offsets;
+    neighborList = links.targets;
+    for (int u = 0; u < numNodes; ++u) {
+        uint64_t *r = rows.data() + (size_t)u * wordsPerRow;
+        for (int n = neighborStart[u]; n < neighborStart[u + 1]; ++n)
+            r[neighborList[n] >> 6] |= 1ULL << (neighborList[n] & 63);
+    }
+}
+
+long BitGraph::numEdges() const
+{
+    long count = 0;
+    for (uint64_t word : rows)
+        count += __builtin_popcountll(word);
+    return count / 2;
+}
+
+void BitGraph::neighbors(int u, std::vector<int>& result) const
+{
+    result.assign(neighborList.begin() + neighborStart[u], neighborList.begin() + neighborStart[u + 1]);
+}
+
+void BitGraph::diff(const BitGraph& other, std::vector<std::pair<int, int>>& changedEdges) const
+{
+    changedEdges.clear();
+    for (int u = 0; u < numNodes; ++u) {
+        const uint64_t *r = row(u);
+        const uint64_t *o = other.row(u);
+        // Only the upper triangle, starting at the word that holds u + 1
+        for (int w = (u + 1) >> 6; w < wordsPerRow; ++w) {
+            uint64_t bits = r[w] ^ o[w];
+            if (w == (u + 1) >> 6)
+                bits &= ~0ULL << ((u + 1) & 63);
+            for (; bits; bits &= bits - 1)
+                changedEdges.push_back({ u, (w << 6) + __builtin_ctzll(bits) });
+        }
+    }
+}
+
+void BitGraph::search(int root, std::vector<int>& dist, std::vector<int>& previous, std::vector<int> *firstHop) const
+{
+    dist.assign(numNodes, INT_MAX);
+    previous.assign(numNodes, -1);
+    if (firstHop) {
+        firstHop->assign(numNodes, -1);
+        (*firstHop)[root] = root;
+    }
+    std::vector<int> frontier(1, root);
+    dist[root] = 0;
+    expand(frontier, dist, previous, firstHop, root);
+}
+
+void BitGraph::searchNearest(const std::vector<int>& roots, std::vector<int>& dist, std::vector<int>& previous, std::vector<int>& nearestRoot) const
+{
+    dist.assign(numNodes, INT_MAX);
+    previous.assign(numNodes, -1);
+    nearestRoot.assign(numNodes, -1);
+    std::vector<int> frontier;
+    for (int root : roots) {
+        if (root < 0 || root >= numNodes || dist[root] == 0)
+            continue;
+        dist[root] = 0;
+        nearestRoot[root] = root;
+        frontier.push_back(root);
+    }
+    std::sort(frontier.begin(), frontier.end());
+    // Passing no first-hop root makes every node inherit the label of its predecessor
+    expand(frontier, dist, previous, &nearestRoot, -1);
+}
+
+void BitGraph::alternateFirstHops(int root, const std::vector<int>& dist, const std::vector<int>& firstHop, std::vector<int>& alternate) const
+{
+    alternate.assign(numNodes, -1);
+    std::vector<int> length(numNodes, INT_MAX);
+    std::vector<int> via(numNodes, -1); // a second neighbor of root on the alternate path, -1 if none
+    std::vector<int> downstream(numNodes, -1); // best alternate of exactly dist hops
+    std::vector<int> downstreamVia(numNodes, -1);
+
+    // Nodes ordered by level (counting sort), root excluded
+    int numLevels = 0;
+    for (int v = 0; v < numNodes; ++v) {
+        if (v != root && dist[v] != INT_MAX)
+            numLevels = std::max(numLevels, dist[v] + 1);
+    }
+    std::vector<int> levelStart(numLevels + 1, 0);
+    for (int v = 0; v < numNodes; ++v) {
+        if (v != root && dist[v] != INT_MAX)
+            ++levelStart[dist[v] + 1];
+    }
+    for (int level = 0; level < numLevels; ++level)
+        levelStart[level + 1] += levelStart[level];
+    std::vector<int> byLevel(levelStart[numLevels]);
+    std::vector<int> fill(levelStart.begin(), levelStart.end() - 1);
+    for (int v = 0; v < numNodes; ++v) {
+        if (v != root && dist[v] != INT_MAX)
+            byLevel[fill[dist[v]]++] = v;
+    }
+
+    auto consider = [&](int v, int label, int labelLength, int labelVia, int& best, int& bestLength, int& bestVia) {
+        if (label == -1 || label == firstHop[v])
+            return;
+        bool avoids = labelVia != firstHop[v] || labelVia == v;
+        bool bestAvoids = best != -1 && (bestVia != firstHop[v] || bestVia == v);
+        if (best == -1 || (avoids && !bestAvoids) || (avoids == bestAvoids && labelLength < bestLength)) {
+            best = label;
+            bestLength = labelLength;
+            bestVia = labelVia;
+        }
+    };
+
+    std::vector<int> sameLevelStart, sameLevelNeighbors; // kept from the first pass for the second
+
+    // A path of at most dist + 1 hops climbs one level per hop except for at most one hop within a level.
+    // The first pass extends paths from the previous level, the second adds the hop within the level.
+    // Both walk neighbor lists, since alternates only need the links of each node, not whole rows.
+    for (int level = 1; level < numLevels; ++level) {
+        sameLevelStart.assign(1, 0);
+        sameLevelNeighbors.clear();
+        for (int k = levelStart[level]; k < levelStart[level + 1]; ++k) {
+            int v = byLevel[k];
+            int downstreamLength = level;
+            for (int n = neighborStart[v]; n < neighborStart[v + 1]; ++n) {
+                int u = neighborList[n];
+                if (dist[u] == level) {
+                    sameLevelNeighbors.push_back(u);
+                    continue;
+                }
+                if (dist[u] != level - 1 || u == root)
+                    continue;
+                consider(v, firstHop[u], level, -1, alternate[v], length[v], via[v]);
+                consider(v, alternate[u], length[u] + 1, via[u], alternate[v], length[v], via[v]);
+                consider(v, firstHop[u], level, -1, downstream[v], downstreamLength, downstreamVia[v]);
+                if (length[u] == level - 1)
+                    consider(v, alternate[u], level, via[u], downstream[v], downstreamLength, downstreamVia[v]);
+            }
+            sameLevelStart.push_back(sameLevelNeighbors.size());
+        }
+        for (int k = levelStart[level]; k < levelStart[level + 1]; ++k) {
+            int v = byLevel[k];
+            int i = k - levelStart[level];
+            for (int n = sameLevelStart[i]; n < sameLevelStart[i + 1]; ++n) {
+                int u = sameLevelNeighbors[n];
+                // On the first level the path runs root, u, v, so v itself is a neighbor of root on it
+                consider(v, firstHop[u], level + 1, level == 1 ? v : -1, alternate[v], length[v], via[v]);
+                consider(v, downstream[u], level + 1, downstreamVia[u], alternate[v], length[v], via[v]);
+            }
+        }
+    }
+}
+
+void BitGraph::expand(std::vector<int>& frontier, std::vector<int>& dist, std::vector<int>& previous, std::vector<int> *label, int root) const
+{
+    std::vector<uint64_t> visited(wordsPerRow, 0);
+    std::vector<int> next;
+    frontier.reserve(numNodes);
+    next.reserve(numNodes);
+    for (int u : frontier)
+        visited[u >> 6] |= 1ULL << (u & 63);
+
+    for (int level = 1; !frontier.empty(); ++level) {
+        next.clear();
+        for (int u : frontier) {
+            const uint64_t *r = row(u);
+            for (int w = 0; w < wordsPerRow; w += 4) {
+#ifdef __AVX2__
+                __m256i adjacent = _mm256_loadu_si256((const __m256i *)(r + w));
+                __m256i seen = _mm256_loadu_si256((const __m256i *)(visited.data() + w));
+                __m256i discovered = _mm256_andnot_si256(seen, adjacent);
+                if (_mm256_testz_si256(discovered, discovered))
+                    continue;
+                _mm256_storeu_si256((__m256i *)(visited.data() + w), _mm256_or_si256(seen, discovered));
+                uint64_t words[4];
+                _mm256_storeu_si256((__m256i *)words, discovered);
+#else
+                uint64_t words[4];
+                uint64_t any = 0;
+                for (int k = 0; k < 4; ++k) {
+                    words[k] = r[w + k] & ~visited[w + k];
+                    visited[w + k] |= words[k];
+                    any |= words[k];
+                }
+                if (!any)
+                    continue;
+#endif
+                for (int k = 0; k < 4; ++k) {
+                    for (uint64_t bits = words[k]; bits; bits &= bits - 1) {
+                        int v = ((w + k) << 6) + __builtin_ctzll(bits);
+                        dist[v] = level;
+                        previous[v] = u;
+                        if (label)
+                            (*label)[v] = (u == root) ? v : (*label)[u];
+                        next.push_back(v);
+                    }
+                }
+            }
+        }
+        // The next frontier has to be expanded in ascending index order as well
+        std::sort(next.begin(), next.end());
+        frontier.swap(next);
+    }
+}
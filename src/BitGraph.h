@@ -0,0 +1,72 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef BITGRAPH_H_
+#define BITGRAPH_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include "AdjacencyLists.h"
+
+// Unweighted graph with adjacency rows stored as packed bitsets.
+// Breadth-first searches expand a whole row per frontier node with word-wide
+// AND-NOT/OR operations (four words at a time when compiled with AVX2).
+class BitGraph {
+
+public:
+   void assign(const AdjacencyLists& links);
+   int size() const { return numNodes; }
+   bool hasEdge(int u, int v) const { return (row(u)[v >> 6] >> (v & 63)) & 1; }
+   long numEdges() const;
+   size_t memoryBytes() const { return rows.capacity() * sizeof(uint64_t) + (neighborStart.capacity() + neighborList.capacity()) * sizeof(int); }
+   void neighbors(int u, std::vector<int>& result) const; // ascending
+
+   // Links (u < v) present in exactly one of this graph and other, which must have the same size
+   void diff(const BitGraph& other, std::vector<std::pair<int, int>>& changedEdges) const;
+
+   // Hop counts from root (INT_MAX if unreachable) and the predecessor of every node (-1 for root and unreachable nodes).
+   // Frontier nodes are expanded in ascending index order, so each node's predecessor is its lowest-index
+   // neighbor on the previous level, which is the same tie-breaking as the binary-heap Dijkstra it replaces.
+   // If firstHop is given, the first hop from root is carried forward along every discovered link
+   // (root for itself, -1 if unreachable), so no walk back over the predecessors is needed.
+   void search(int root, std::vector<int>& dist, std::vector<int>& previous, std::vector<int> *firstHop = nullptr) const;
+
+   // One search started from all roots at once: hop counts and predecessors towards the nearest root, and
+   // that root in nearestRoot (-1 if unreachable). Ties go to the root behind the lowest-index predecessor.
+   void searchNearest(const std::vector<int>& roots, std::vector<int>& dist, std::vector<int>& previous, std::vector<int>& nearestRoot) const;
+
+   // Second first hop from root for every node, given dist and firstHop of search(root): a different neighbor of root
+   // that starts a path of at most dist + 1 hops, or -1 if there is none. That neighbor is at most dist hops from the
+   // node, so its own shortest path never leads back through root. Alternates whose path avoids the node's first hop
+   // are preferred, then shorter ones.
+   void alternateFirstHops(int root, const std::vector<int>& dist, const std::vector<int>& firstHop, std::vector<int>& alternate) const;
+
+private:
+   int numNodes = 0;
+   int wordsPerRow = 0; // padded to a multiple of four words
+   std::vector<uint64_t> rows;
+   std::vector<int> neighborStart; // neighbor lists of u are [neighborStart[u], neighborStart[u + 1]) in neighborList
+   std::vector<int> neighborList;
+
+   const uint64_t *row(int u) const { return rows.data() + (size_t)u * wordsPerRow; }
+   // Level-by-level expansion from the nodes in frontier, which must be sorted and have distance 0.
+   // Discovered nodes take the label of their predecessor, or their own index when reached directly from root.
+   void expand(std::vector<int>& frontier, std::vector<int>& dist, std::vector<int>& previous, std::vector<int> *label, int root) const;
+};
+
+#endif /* BITGRAPH_H_ */
@@ -84,6 +84,7 @@ void Dspr::initialize(int stage)
         startRecordingTime = par("startRecordingTime");
         stopRecordingTime = par("stopRecordingTime");
         timeToLive = par("timeToLive");
+        recordHookTiming = par("recordHookTiming");
 
         int nodeId = node->getIndex();
         EV<<"Node ID: " << nodeId << endl;
@@ -101,7 +102,6 @@ void Dspr::initialize(int stage)
         //const char *file_name = par("groundstationsTraceFile");
         //parseGroundstationTraceFile2Vector(file_name); //working
         a2gOutputInterface = par("a2gOutputInterface");
-        groundStationRange = par("groundStationRange");
         // enableRoutingQueue = par("enableRoutingQueue").boolValue();
         // maxQueueCount = par("maxQueueCount"); // Initialize maxQueueCount from the parameter
         // reinjectDelayTime = par("reinjectDelayTime"); // Initialize reinjectDelayTime from the parameter
@@ -237,11 +237,10 @@ L3Address Dspr::getSenderNeighborAddress(const Ptr<const NetworkHeaderBase>& net
 
 DsprInfo *Dspr::createDsprInfo()
 {
+    // The network header takes ownership of its options and deletes them with itself, so the option
+    // cannot be recycled; only its length is computed once per start instead of once per packet
     DsprInfo *dsprInfo = new DsprInfo();
-    int addressesBytes = 3 * getSelfAddress().getAddressType()->getAddressByteLength();
-    int tlBytes = 1 + 1;
-    int packetLength = tlBytes + addressesBytes;
-    dsprInfo->setLength(packetLength);
+    dsprInfo->setLength(dsprInfoLength);
     return dsprInfo;
 }
 
@@ -330,63 +329,74 @@ DsprInfo *Dspr::createDsprInfo()
 
 INetfilter::IHook::Result Dspr::routeDatagram(Packet *datagram, DsprInfo *dsprInfo)
 {
-    const auto& ipv4Header = datagram->peekAtFront<Ipv4Header>();
     const auto& networkHeader = getNetworkProtocolHeader(datagram);
-    const L3Address& source = getSelfAddress(); 
     const L3Address& destination = networkHeader->getDestinationAddress();
-    auto payload = datagram->peekAtBack();
-
-    // Retrieve the creationTime
-    const auto& creationTimeTag = payload->findTag<CreationTimeTag>();
-    if (creationTimeTag == nullptr) {
-        EV_WARN << "CreationTimeTag not found in the packet." << endl;
-        // throw cRuntimeError("CreationTimeTag not found in the packet.");
+    L3Address nextHopAddress = nodeManager->findNextHop(selfAddress, destination);
+    if (isBrokenNextHop(nextHopAddress)) {
+        // Local repair until the next route update
+        L3Address backupAddress = nodeManager->findBackupNextHop(selfAddress, destination);
+        EV_WARN << "Link to next hop " << nextHopAddress << " is broken, switching to backup next hop " << backupAddress << endl;
+        nextHopAddress = isBrokenNextHop(backupAddress) ? L3Address() : backupAddress;
     }
-    // simtime_t creationTime = creationTimeTag->getCreationTime();
-
-
-    EV_INFO << "Finding next hop: source = " << source << ", destination = " << destination << endl;
-    // temporary recalculate routes before each packet routing
-    // nodeManager->recalculateRoutes();
-    L3Address nextHopAddress = nodeManager->findNextHop(source, destination);
     datagram->addTagIfAbsent<NextHopAddressReq>()->setNextHopAddress(nextHopAddress);
     if (nextHopAddress.isUnspecified()) {
-        EV_WARN << "No next hop found, dropping packet: source = " << source << ", destination = " << destination << endl;
+        EV_WARN << "No next hop found, dropping packet: source = " << selfAddress << ", destination = " << destination << endl;
         emit(routingFailedSignal, simTime());
+        if (packetTrace)
+            tracePacket(PACKET_DROPPED, dsprInfo);
         if (displayBubbles && hasGUI())
             getContainingNode(node)->bubble("No next hop found, dropping packet");
         return DROP;
     }
-    else {
-        EV_INFO << "Next hop found: source = " << source << ", destination = " << destination << ", nextHop: " << nextHopAddress << endl;
-        dsprInfo->setSenderAddress(source);
-        dsprInfo->setCurrentSenderAddress(getSelfAddress());
-        dsprInfo->setCurrentReceiverAddress(nextHopAddress);
-        // auto interfaceEntry = CHK(interfaceTable->findInterfaceByName(outputInterface));
-        // datagram->addTagIfAbsent<InterfaceReq>()->setInterfaceId(interfaceEntry->getInterfaceId());
-        // L3Address groundStationAddress = nodeManager->destAddress;
-        Coord destination_position = nodeManager->destPosition;
-        EV << "Destination Position is: " << destination_position << endl;
-        Coord current_aircraft_position = mobility->getCurrentPosition();
-        double distanceToGroundStation = current_aircraft_position.distance(destination_position);
-        if(distanceToGroundStation <= groundStationRange){
-           if (creationTimeTag && creationTimeTag->getCreationTime() >= startRecordingTime && (creationTimeTag->getCreationTime() <= stopRecordingTime || stopRecordingTime == -1)) {
-                emit(hopCountSignal, timeToLive - (ipv4Header->getTimeToLive()) + 1);
-           }
-           EV_INFO << "Hop count for application packet = " << timeToLive - (ipv4Header->getTimeToLive()) + 1 << endl;
-           EV << " Ground Station is within communication range." << endl;
-           EV << "Switch on the Air-to-Ground Link." << endl;
-           auto a2gInterfaceEntry = CHK(interfaceTable->findInterfaceByName(a2gOutputInterface));
-           datagram->addTagIfAbsent<InterfaceReq>()->setInterfaceId(a2gInterfaceEntry->getInterfaceId());
-           EV_INFO << " Interface ID = " << a2gInterfaceEntry << endl;
-           return ACCEPT;
-        }
-        EV << "Transmit through Air-to-Air link." << endl;
-        auto interfaceEntry = CHK(interfaceTable->findInterfaceByName(outputInterface));
-        datagram->addTagIfAbsent<InterfaceReq>()->setInterfaceId(interfaceEntry->getInterfaceId());
-        EV_INFO << " Interface ID = " << interfaceEntry << endl;
-        return ACCEPT;
+    dsprInfo->setSenderAddress(selfAddress);
+    dsprInfo->setCurrentSenderAddress(selfAddress);
+    dsprInfo->setCurrentReceiverAddress(nextHopAddress);
+    dsprInfo->setHopCount(dsprInfo->getHopCount() + 1);
+    // Only the hop onto a ground station uses the air-to-ground link; weighted routes may relay through an aircraft
+    // even when a ground station is in range
+    bool airToGround = nodeManager->isGroundStation(nextHopAddress);
+    if (airToGround && isInRecordingWindow(datagram)) {
+        if (auto ipv4Header = dynamicPtrCast<const Ipv4Header>(networkHeader))
+            emit(hopCountSignal, timeToLive - ipv4Header->getTimeToLive() + 1);
+    }
+    EV_INFO << "Next hop found: source = " << selfAddress << ", destination = " << destination << ", nextHop: " << nextHopAddress
+            << (airToGround ? ", air-to-ground link" : ", air-to-air link") << endl;
+    int interfaceId = airToGround ? a2gOutputInterfaceId : outputInterfaceId;
+    if (interfaceId == -1)
+        throw cRuntimeError("Interface '%s' not found", airToGround ? a2gOutputInterface : outputInterface);
+    datagram->addTagIfAbsent<InterfaceReq>()->setInterfaceId(interfaceId);
+    if (packetTrace)
+        tracePacket(PACKET_ROUTED, dsprInfo, nextHopAddress, airToGround ? AIR_TO_GROUND : AIR_TO_AIR);
+    return ACCEPT;
+}
+
+void Dspr::tracePacket(PacketTraceEvent event, const DsprInfo *dsprInfo, const L3Address& nextHop, PacketTraceInterface interface)
+{
+    PacketTraceRecord record = {};
+    record.simTime = simTime().dbl();
+    record.nodeId = node->getId();
+    record.sourceNodeId = dsprInfo->getSourceNodeId();
+    record.sequenceNumber = dsprInfo->getSequenceNumber();
+    record.nextHop = ipv4AddressValue(nextHop);
+    record.hopCount = dsprInfo->getHopCount();
+    record.event = event;
+    record.interface = interface;
+    packetTrace->append(record);
+}
+
+simtime_t Dspr::getCreationTime(Packet *packet) const
+{
+    const auto& creationTimeTag = packet->peekAtBack()->findTag<CreationTimeTag>();
+    if (creationTimeTag == nullptr) {
+        EV_WARN << "CreationTimeTag not found in the packet." << endl;
+        return -1;
     }
+    return creationTimeTag->getCreationTime();
+}
+
+bool Dspr::isInRecordingWindow(simtime_t creationTime) const
+{
+    return creationTime >= 0 && creationTime >= startRecordingTime && (creationTime <= stopRecordingTime || stopRecordingTime == -1);
 }
 
 // void Dspr::delayDatagram(Packet *datagram)
@@ -435,20 +445,22 @@ INetfilter::IHook::Result Dspr::routeDatagram(Packet *datagram, DsprInfo *dsprIn
 // //     }
 // // }
 
-void Dspr::setDsprInfoOnNetworkDatagram(Packet *packet, const Ptr<const NetworkHeaderBase>& networkHeader, DsprInfo *dsprInfo)
+void Dspr::setDsprInfoOnNetworkDatagram(Packet *packet, const Ptr<const NetworkHeaderBase>& networkHeader, DsprInfo *dsprInfo, const L3Address& destination)
 {
     packet->trimFront();
 #ifdef WITH_IPv4
     if (dynamicPtrCast<const Ipv4Header>(networkHeader)) {
+        // The option changes the header length, so the header has to be removed and inserted again
         auto ipv4Header = removeNetworkProtocolHeader<Ipv4Header>(packet);
         dsprInfo->setType(IPOPTION_TLV_GPSR);
-        B oldHlen = ipv4Header->calculateHeaderByteLength();
-        ASSERT(ipv4Header->getHeaderLength() == oldHlen);
+        B oldHlen = ipv4Header->getHeaderLength();
+        ASSERT(ipv4Header->calculateHeaderByteLength() == oldHlen);
         ipv4Header->addOption(dsprInfo);
         B newHlen = ipv4Header->calculateHeaderByteLength();
         ipv4Header->setHeaderLength(newHlen);
         ipv4Header->addChunkLength(newHlen - oldHlen);
         ipv4Header->setTotalLengthField(ipv4Header->getTotalLengthField() + newHlen - oldHlen);
+        ipv4Header->setDestAddress(destination.toIpv4());
         insertNetworkProtocolHeader(packet, Protocol::ipv4, ipv4Header);
     }
     else
@@ -468,6 +480,7 @@ void Dspr::setDsprInfoOnNetworkDatagram(Packet *packet, const Ptr<const NetworkH
         hdr->setByteLength(B(utils::roundUp(2 + B(hdr->getTlvOptions().getLength()).get(), 8)));
         B newHlen = ipv6Header->calculateHeaderByteLength();
         ipv6Header->addChunkLength(newHlen - oldHlen);
+        ipv6Header->setDestAddress(destination.toIpv6());
         insertNetworkProtocolHeader(packet, Protocol::ipv6, ipv6Header);
     }
     else
@@ -480,6 +493,7 @@ void Dspr::setDsprInfoOnNetworkDatagram(Packet *packet, const Ptr<const NetworkH
         nextHopHeader->getTlvOptionsForUpdate().insertTlvOption(dsprInfo);
         int newHlen = nextHopHeader->getTlvOptions().getLength();
         nextHopHeader->addChunkLength(B(newHlen - oldHlen));
+        nextHopHeader->setDestAddr(destination);
         insertNetworkProtocolHeader(packet, Protocol::nextHopForwarding, nextHopHeader);
     }
     else
@@ -572,21 +586,58 @@ DsprInfo *Dspr::getDsprInfoFromNetworkDatagramForUpdate(const Ptr<NetworkHeaderB
     return dsprInfo;
 }
 
+DsprInfo *Dspr::getExclusiveDsprInfoForUpdate(Packet *packet)
+{
+    packet->trimFront();
+    const auto& networkHeader = getNetworkProtocolHeader(packet);
+    DsprInfo *dsprInfo = nullptr;
+#ifdef WITH_IPv4
+    if (dynamicPtrCast<const Ipv4Header>(networkHeader)) {
+        // Removing a shared header duplicates it, options included
+        auto ipv4Header = removeNetworkProtocolHeader<Ipv4Header>(packet);
+        dsprInfo = getDsprInfoFromNetworkDatagramForUpdate(ipv4Header);
+        insertNetworkProtocolHeader(packet, Protocol::ipv4, ipv4Header);
+    }
+    else
+#endif
+#ifdef WITH_IPv6
+    if (dynamicPtrCast<const Ipv6Header>(networkHeader)) {
+        auto ipv6Header = removeNetworkProtocolHeader<Ipv6Header>(packet);
+        dsprInfo = getDsprInfoFromNetworkDatagramForUpdate(ipv6Header);
+        insertNetworkProtocolHeader(packet, Protocol::ipv6, ipv6Header);
+    }
+    else
+#endif
+#ifdef WITH_NEXTHOP
+    if (dynamicPtrCast<const NextHopForwardingHeader>(networkHeader)) {
+        auto nextHopHeader = removeNetworkProtocolHeader<NextHopForwardingHeader>(packet);
+        dsprInfo = getDsprInfoFromNetworkDatagramForUpdate(nextHopHeader);
+        insertNetworkProtocolHeader(packet, Protocol::nextHopForwarding, nextHopHeader);
+    }
+    else
+#endif
+    {
+        throw cRuntimeError("Dspr info not found in datagram!");
+    }
+    return dsprInfo;
+}
+
 //
 // netfilter
 //
 
 INetfilter::IHook::Result Dspr::datagramPreRoutingHook(Packet *datagram)
 {
-    EV_INFO << "I am datagramPreRoutingHook " << endl;   
     Enter_Method("datagramPreRoutingHook");
+    HookTimer timer(this);
     const auto& networkHeader = getNetworkProtocolHeader(datagram);
     const L3Address& destination = networkHeader->getDestinationAddress();
     if (destination.isMulticast() || destination.isBroadcast() || routingTable->isLocalAddress(destination))
         return ACCEPT;
     else {
-        // KLUDGE: this allows overwriting the Dspr option inside
-        auto dsprInfo = const_cast<DsprInfo *>(getDsprInfoFromNetworkDatagram(networkHeader));
+        // The header is shared with other copies of the packet, such as the one a MAC keeps for retransmission,
+        // which must not see the hop count and addresses that routing writes into the option
+        DsprInfo *dsprInfo = getExclusiveDsprInfoForUpdate(datagram);
         return routeDatagram(datagram, dsprInfo);
     }
 }
@@ -594,31 +645,27 @@ INetfilter::IHook::Result Dspr::datagramPreRoutingHook(Packet *datagram)
 INetfilter::IHook::Result Dspr::datagramLocalOutHook(Packet *packet)
 {
     Enter_Method("datagramLocalOutHook");
-    EV_INFO << "I am datagramLocalOutHook " << endl;
-
-    auto payload = packet->peekAtBack();
-
-    // Retrieve the creationTime
-    const auto& creationTimeTag = payload->findTag<CreationTimeTag>();
-    if (creationTimeTag == nullptr) {
-        EV_WARN << "CreationTimeTag not found in the packet." << endl;
-        // throw cRuntimeError("CreationTimeTag not found in the packet.");
-    }
-    // simtime_t creationTime = creationTimeTag->getCreationTime();
-    double combinedId = node->getIndex() + static_cast<double>(packetID) / 10000.0;
-
-    if (creationTimeTag && creationTimeTag->getCreationTime() >= startRecordingTime && (creationTimeTag->getCreationTime() <= stopRecordingTime || stopRecordingTime == -1)) {        
-        emit(packetIdSentSignal, combinedId);
-        packetID += 1;
-    }
+    HookTimer timer(this);
+    int sourceNodeId = node->getId();
+    uint32_t packetSequenceNumber = sequenceNumber++;
+    bool recorded = isInRecordingWindow(packet);
+    if (recorded)
+        emit(packetIdSentSignal, dsprPacketId(sourceNodeId, packetSequenceNumber));
     const auto& networkHeader = getNetworkProtocolHeader(packet);
     const L3Address& destination = networkHeader->getDestinationAddress();
     if (destination.isMulticast() || destination.isBroadcast() || routingTable->isLocalAddress(destination))
         return ACCEPT;
     else {
+        // Only routed packets carry the id that the receiver reports back
+        if (recorded)
+            nodeManager->recordPacketSent();
         DsprInfo *dsprInfo = createDsprInfo();
-        dsprInfo->setNodeIndex(combinedId);
-        setDsprInfoOnNetworkDatagram(packet, networkHeader, dsprInfo);
+        dsprInfo->setSourceNodeId(sourceNodeId);
+        dsprInfo->setSequenceNumber(packetSequenceNumber);
+        // Every hop then routes towards the same ground station, which accepts the packet as its own
+        setDsprInfoOnNetworkDatagram(packet, networkHeader, dsprInfo, nodeManager->findNearestDestination(selfAddress, destination));
+        if (packetTrace)
+            tracePacket(PACKET_SENT, dsprInfo);
         return routeDatagram(packet, dsprInfo);
     }
     
@@ -627,28 +674,18 @@ INetfilter::IHook::Result Dspr::datagramLocalOutHook(Packet *packet)
 INetfilter::IHook::Result Dspr::datagramLocalInHook(Packet *packet)
 {
     Enter_Method("datagramLocalInHook");
-    EV_INFO << "I am datagramLocalInHook " << endl;
-    const auto& ipv4Header = packet->peekAtFront<Ipv4Header>();
+    HookTimer timer(this);
     const auto& networkHeader = getNetworkProtocolHeader(packet);
-    const L3Address& destination = networkHeader->getDestinationAddress();
-    const L3Address& source = networkHeader->getDestinationAddress();
     const DsprInfo *dsprInfo = findDsprInfoInNetworkDatagram(networkHeader);
-    auto payload = packet->peekAtBack();
-
-    // Retrieve the creationTime
-    const auto& creationTimeTag = payload->findTag<CreationTimeTag>();
-    if (creationTimeTag == nullptr) {
-        EV_WARN << "CreationTimeTag not found in the packet." << endl;
-        // throw cRuntimeError("CreationTimeTag not found in the packet.");
-    }
-    // simtime_t creationTime = creationTimeTag->getCreationTime();
-    
     if (dsprInfo != nullptr){
         EV_INFO << "Packet Received " << endl;
-        double receivedId = dsprInfo->getNodeIndex();
-        if (creationTimeTag && creationTimeTag->getCreationTime() >= startRecordingTime && (creationTimeTag->getCreationTime() <= stopRecordingTime || stopRecordingTime == -1)) {
-            emit(packetIDReceivedSignal, receivedId);
+        simtime_t creationTime = getCreationTime(packet);
+        if (isInRecordingWindow(creationTime)) {
+            emit(packetIDReceivedSignal, dsprPacketId(dsprInfo->getSourceNodeId(), dsprInfo->getSequenceNumber()));
+            nodeManager->recordPacketReceived(dsprInfo->getSourceNodeId(), dsprInfo->getSequenceNumber(), simTime() - creationTime, dsprInfo->getHopCount());
         }
+        if (packetTrace)
+            tracePacket(PACKET_RECEIVED, dsprInfo);
     }
     return ACCEPT;
 }
@@ -656,6 +693,16 @@ INetfilter::IHook::Result Dspr::datagramLocalInHook(Packet *packet)
 void Dspr::handleStartOperation(LifecycleOperation *operation)
 {
     configureInterfaces();
+    selfAddress = getSelfAddress();
+    int addressesBytes = 3 * selfAddress.getAddressType()->getAddressByteLength();
+    int tlBytes = 1 + 1;
+    dsprInfoLength = tlBytes + addressesBytes;
+    // Not every node type has both interfaces, so a missing one is only an error once routing selects it
+    InterfaceEntry *outputInterfaceEntry = interfaceTable->findInterfaceByName(outputInterface);
+    outputInterfaceId = outputInterfaceEntry ? outputInterfaceEntry->getInterfaceId() : -1;
+    InterfaceEntry *a2gOutputInterfaceEntry = interfaceTable->findInterfaceByName(a2gOutputInterface);
+    a2gOutputInterfaceId = a2gOutputInterfaceEntry ? a2gOutputInterfaceEntry->getInterfaceId() : -1;
+    packetTrace = nodeManager->getPacketTrace();
 }
 
 void Dspr::handleStopOperation(LifecycleOperation *operation)
@@ -670,6 +717,16 @@ void Dspr::handleCrashOperation(LifecycleOperation *operation)
    EV << "Total packets received at the destination node: " << packetReceived << endl;
 }
 
+void Dspr::finish()
+{
+    if (recordHookTiming && numHookCalls > 0) {
+        double seconds = std::chrono::duration<double>(hookTime).count();
+        recordScalar("routingHookCalls", numHookCalls);
+        recordScalar("routingHookTime", seconds, "s");
+        recordScalar("routingHooksPerSecond", seconds > 0 ? numHookCalls / seconds : 0);
+    }
+}
+
 // void Dspr::finish(){
 
 //     EV << "Hop count, min:    " << hopCountStats.getMin() << endl;
@@ -685,6 +742,25 @@ void Dspr::receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj,
     Enter_Method("receiveChangeNotification");
     if (signalID == linkBrokenSignal) {
         EV_WARN << "Received link break" << endl;
-        // TODO: remove the neighbor
+        // The failed packet still carries the DSPR option with the next hop it was sent to
+        Packet *datagram = check_and_cast<Packet *>(obj);
+        const auto& networkHeader = findNetworkProtocolHeader(datagram);
+        if (networkHeader == nullptr)
+            return;
+        const DsprInfo *dsprInfo = findDsprInfoInNetworkDatagram(networkHeader);
+        if (dsprInfo == nullptr || dsprInfo->getCurrentReceiverAddress().isUnspecified())
+            return;
+        long routeEpoch = nodeManager->getRouteEpoch();
+        if (brokenNextHopsEpoch != routeEpoch) {
+            brokenNextHops.clear();
+            brokenNextHopsEpoch = routeEpoch;
+        }
+        brokenNextHops.insert(dsprInfo->getCurrentReceiverAddress());
+        EV_WARN << "Avoiding next hop " << dsprInfo->getCurrentReceiverAddress() << " until the next route update" << endl;
     }
 }
+
+bool Dspr::isBrokenNextHop(const L3Address& address) const
+{
+    return !brokenNextHops.empty() && brokenNextHopsEpoch == nodeManager->getRouteEpoch() && brokenNextHops.count(address) > 0;
+}
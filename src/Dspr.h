@@ -20,6 +20,8 @@
 #include <omnetpp.h>
 #include <vector>
 #include <map>
+#include <set>
+#include <chrono>
 #include "inet/common/INETDefs.h"
 #include "inet/common/packet/Packet.h"
 #include "inet/queueing/contract/IPacketQueue.h"
@@ -36,6 +38,7 @@
 #include "inet/networklayer/ipv4/Ipv4InterfaceData.h"
 #include "inet/common/TimeTag_m.h"
 #include "NodeManager.h"
+#include "PacketTrace.h"
 #include "Dspr_m.h"
 #include "DsprDefs.h"
 
@@ -56,7 +59,34 @@ class Dspr : public RoutingProtocolBase, public cListener, public NetfilterBase:
     simsignal_t packetIdSentSignal;
     simsignal_t packetIDReceivedSignal;
 
-    int packetID = 0;
+    uint32_t sequenceNumber = 0; // of the next packet this node originates
+
+    // Next hops reported by linkBrokenSignal, valid until NodeManager refreshes the routes
+    std::set<L3Address> brokenNextHops;
+    long brokenNextHopsEpoch = -1;
+    bool isBrokenNextHop(const L3Address& address) const;
+
+    // Resolved when the node starts, so routing a packet needs no address or interface lookups
+    L3Address selfAddress;
+    int outputInterfaceId = -1;
+    int a2gOutputInterfaceId = -1; // both -1 if the node has no such interface
+    int dsprInfoLength = 0; // option length in bytes for the node's address type
+    PacketTraceSink *packetTrace = nullptr; // NodeManager's trace sink, nullptr if tracing is off
+    void tracePacket(PacketTraceEvent event, const DsprInfo *dsprInfo, const L3Address& nextHop = L3Address(), PacketTraceInterface interface = NO_INTERFACE);
+    simtime_t getCreationTime(Packet *packet) const; // -1 if the packet has no CreationTimeTag
+    bool isInRecordingWindow(simtime_t creationTime) const;
+    bool isInRecordingWindow(Packet *packet) const { return isInRecordingWindow(getCreationTime(packet)); }
+
+    // Wall-clock time spent in the routing hooks, recorded in finish() if recordHookTiming is set
+    bool recordHookTiming = false;
+    long numHookCalls = 0;
+    std::chrono::steady_clock::duration hookTime = std::chrono::steady_clock::duration::zero();
+    struct HookTimer {
+        Dspr *dspr;
+        std::chrono::steady_clock::time_point start;
+        explicit HookTimer(Dspr *dspr) : dspr(dspr) { if (dspr->recordHookTiming) start = std::chrono::steady_clock::now(); }
+        ~HookTimer() { if (dspr->recordHookTiming) { dspr->hookTime += std::chrono::steady_clock::now() - start; ++dspr->numHookCalls; } }
+    };
 
   public:
     cModule *node = nullptr;
@@ -64,7 +94,6 @@ class Dspr : public RoutingProtocolBase, public cListener, public NetfilterBase:
     int interfaceId = -1;
     int packetReceived = 0;
     bool displayBubbles;
-    double groundStationRange;
     simtime_t startRecordingTime;
     simtime_t stopRecordingTime;
     int timeToLive;
@@ -99,7 +128,8 @@ class Dspr : public RoutingProtocolBase, public cListener, public NetfilterBase:
 
    // handling packets
      DsprInfo *createDsprInfo();
-     void setDsprInfoOnNetworkDatagram(Packet *packet, const Ptr<const NetworkHeaderBase>& networkHeader, DsprInfo *dsprInfo);
+     // Also sets the destination address of the header, which is removed and inserted again for the option anyway
+     void setDsprInfoOnNetworkDatagram(Packet *packet, const Ptr<const NetworkHeaderBase>& networkHeader, DsprInfo *dsprInfo, const L3Address& destination);
 
      // returns nullptr if not found
      DsprInfo *findDsprInfoInNetworkDatagramForUpdate(const Ptr<NetworkHeaderBase>& networkHeader);
@@ -108,6 +138,8 @@ class Dspr : public RoutingProtocolBase, public cListener, public NetfilterBase:
      // throws an error when not found
      DsprInfo *getDsprInfoFromNetworkDatagramForUpdate(const Ptr<NetworkHeaderBase>& networkHeader);
      const DsprInfo *getDsprInfoFromNetworkDatagram(const Ptr<const NetworkHeaderBase>& networkHeader) const;
+     // Removes the network header and inserts it again, so that the returned option belongs to this packet only
+     DsprInfo *getExclusiveDsprInfoForUpdate(Packet *packet);
 
 
     Coord lookupPositionInGlobalRegistry(const L3Address& address) const;
@@ -149,7 +181,7 @@ class Dspr : public RoutingProtocolBase, public cListener, public NetfilterBase:
     simsignal_t routingFailedSignal;
     // notification
     virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override;
-    //void finish();
+    virtual void finish() override;
 
     // Constructor and destructor
     Dspr();
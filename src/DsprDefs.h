@@ -18,9 +18,23 @@
 #define __INET_DPSRDEFS_H
 
 #include "inet/common/INETDefs.h"
+#include "inet/networklayer/common/L3Address.h"
 
 #define DSPR_UDP_PORT    325
 
+// Packet id of the packetIdSent and packetIDReceived signals: source node module id in the upper bits,
+// sequence number in the lower 32. Exact as a double while module ids stay below 2^21.
+inline double dsprPacketId(int sourceNodeId, uint32_t sequenceNumber)
+{
+    return (double)(((uint64_t)sourceNodeId << 32) | sequenceNumber);
+}
+
+// IPv4 address as an integer for the binary recordings, 0 for other address types
+inline uint32_t ipv4AddressValue(const inet::L3Address& address)
+{
+    return address.getType() == inet::L3Address::IPv4 ? address.toIpv4().getInt() : 0;
+}
+
 
 
 #endif // ifndef __INET_DPSRDEFS_H
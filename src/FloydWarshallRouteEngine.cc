@@ -0,0 +1,184 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include "FloydWarshallRouteEngine.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+// Routes of row i through pivot k: distance dik + dk[j] with next hop nik, kept where strictly shorter.
+// UNREACHABLE_ROUTE is the largest 16-bit value, so the saturating add leaves unreachable entries unreachable.
+static inline void relaxRow(uint16_t *di, uint16_t *ni, const uint16_t *dk, uint16_t dik, uint16_t nik, int length)
+{
+    int j = 0;
+#ifdef __AVX2__
+    __m256i pivotDistance = _mm256_set1_epi16(dik);
+    __m256i pivotNextHop = _mm256_set1_epi16(nik);
+    for (; j + 16 <= length; j += 16) {
+        __m256i current = _mm256_loadu_si256((const __m256i *)(di + j));
+        __m256i candidate = _mm256_adds_epu16(_mm256_loadu_si256((const __m256i *)(dk + j)), pivotDistance);
+        __m256i shortest = _mm256_min_epu16(candidate, current);
+        __m256i unchanged = _mm256_cmpeq_epi16(shortest, current);
+        _mm256_storeu_si256((__m256i *)(di + j), shortest);
+        __m256i nextHops = _mm256_loadu_si256((const __m256i *)(ni + j));
+        _mm256_storeu_si256((__m256i *)(ni + j), _mm256_blendv_epi8(pivotNextHop, nextHops, unchanged));
+    }
+#endif
+    for (; j < length; ++j) {
+        uint16_t candidate = std::min<int>(dk[j] + dik, UNREACHABLE_ROUTE);
+        if (candidate < di[j]) {
+            di[j] = candidate;
+            ni[j] = nik;
+        }
+    }
+}
+
+void FloydWarshallRouteEngine::relaxTile(DijkstraAllPairsOutput& table, int numNodes, int iBlock, int jBlock, int kBlock)
+{
+    int iEnd = std::min(numNodes, (iBlock + 1) * TILE_SIZE);
+    int j0 = jBlock * TILE_SIZE;
+    int length = std::min(numNodes, j0 + TILE_SIZE) - j0;
+    int kEnd = std::min(numNodes, (kBlock + 1) * TILE_SIZE);
+    // Pivots in the outer loop, so that tiles on the pivot row or column may be updated in place
+    for (int k = kBlock * TILE_SIZE; k < kEnd; ++k) {
+        const uint16_t *dk = table.distanceRow(k) + j0;
+        for (int i = iBlock * TILE_SIZE; i < iEnd; ++i) {
+            uint16_t dik = table.distanceRow(i)[k];
+            if (dik == UNREACHABLE_ROUTE || i == k)
+                continue;
+            relaxRow(table.distanceRow(i) + j0, table.nextHopRow(i) + j0, dk, dik, table.nextHopRow(i)[k], length);
+        }
+    }
+}
+
+void FloydWarshallRouteEngine::relaxIndependentTile(DijkstraAllPairsOutput& table, int numNodes, int iBlock, int jBlock, int kBlock)
+{
+#ifdef __AVX2__
+    const int vectorsPerRow = TILE_SIZE / 16;
+    int j0 = jBlock * TILE_SIZE;
+    if (j0 + TILE_SIZE > numNodes) {
+        relaxTile(table, numNodes, iBlock, jBlock, kBlock);
+        return;
+    }
+    int iEnd = std::min(numNodes, (iBlock + 1) * TILE_SIZE);
+    int k0 = kBlock * TILE_SIZE;
+    int kEnd = std::min(numNodes, k0 + TILE_SIZE);
+    for (int i = iBlock * TILE_SIZE; i < iEnd; ++i) {
+        uint16_t *di = table.distanceRow(i) + j0;
+        uint16_t *ni = table.nextHopRow(i) + j0;
+        const uint16_t *dik = table.distanceRow(i);
+        const uint16_t *nik = table.nextHopRow(i);
+        __m256i distances[vectorsPerRow], nextHops[vectorsPerRow];
+        for (int q = 0; q < vectorsPerRow; ++q) {
+            distances[q] = _mm256_loadu_si256((const __m256i *)(di + 16 * q));
+            nextHops[q] = _mm256_loadu_si256((const __m256i *)(ni + 16 * q));
+        }
+        for (int k = k0; k < kEnd; ++k) {
+            if (dik[k] == UNREACHABLE_ROUTE)
+                continue;
+            const uint16_t *dk = table.distanceRow(k) + j0;
+            __m256i pivotDistance = _mm256_set1_epi16(dik[k]);
+            __m256i pivotNextHop = _mm256_set1_epi16(nik[k]);
+            for (int q = 0; q < vectorsPerRow; ++q) {
+                __m256i candidate = _mm256_adds_epu16(_mm256_loadu_si256((const __m256i *)(dk + 16 * q)), pivotDistance);
+                __m256i shortest = _mm256_min_epu16(candidate, distances[q]);
+                nextHops[q] = _mm256_blendv_epi8(pivotNextHop, nextHops[q], _mm256_cmpeq_epi16(shortest, distances[q]));
+                distances[q] = shortest;
+            }
+        }
+        for (int q = 0; q < vectorsPerRow; ++q) {
+            _mm256_storeu_si256((__m256i *)(di + 16 * q), distances[q]);
+            _mm256_storeu_si256((__m256i *)(ni + 16 * q), nextHops[q]);
+        }
+    }
+#else
+    relaxTile(table, numNodes, iBlock, jBlock, kBlock);
+#endif
+}
+
+DijkstraAllPairsOutput FloydWarshallRouteEngine::findAllShortestPaths(const RouteCalculator& routes) const
+{
+    const BitGraph& graph = routes.getGraph();
+    ThreadPool *threadPool = routes.getThreadPool();
+    int numNodes = graph.size();
+    DijkstraAllPairsOutput result;
+    result.reset(numNodes, numNodes, routes.backupRoutes);
+
+    std::vector<int> neighbors;
+    for (int i = 0; i < numNodes; ++i) {
+        result.distanceRow(i)[i] = 0;
+        result.nextHopRow(i)[i] = i;
+        graph.neighbors(i, neighbors);
+        for (int j : neighbors) {
+            result.distanceRow(i)[j] = 1;
+            result.nextHopRow(i)[j] = j;
+        }
+    }
+
+    // Blocked Floyd-Warshall: per pivot block, first the tile on the diagonal, then the rest of its row and
+    // column of tiles, which only depend on the diagonal tile, then all remaining tiles, which only read the
+    // tiles of the pivot row and column. Tiles within the last two phases are independent of each other.
+    int numBlocks = (numNodes + TILE_SIZE - 1) / TILE_SIZE;
+    for (int kBlock = 0; kBlock < numBlocks; ++kBlock) {
+        relaxTile(result, numNodes, kBlock, kBlock, kBlock);
+        threadPool->parallelFor(2 * numBlocks, [&](int b) {
+            if (b < numBlocks && b != kBlock)
+                relaxTile(result, numNodes, kBlock, b, kBlock);
+            else if (b >= numBlocks && b - numBlocks != kBlock)
+                relaxTile(result, numNodes, b - numBlocks, kBlock, kBlock);
+        });
+        threadPool->parallelFor(numBlocks, [&](int iBlock) {
+            if (iBlock == kBlock)
+                return;
+            for (int jBlock = 0; jBlock < numBlocks; ++jBlock) {
+                if (jBlock != kBlock)
+                    relaxIndependentTile(result, numNodes, iBlock, jBlock, kBlock);
+            }
+        });
+    }
+
+    // Sources that are not routed keep only their route to themselves, as with the searches
+    threadPool->parallelFor(numNodes, [&](int src) {
+        if (routes.isRoutedSource(src))
+            return;
+        std::fill(result.distanceRow(src), result.distanceRow(src) + numNodes, UNREACHABLE_ROUTE);
+        std::fill(result.nextHopRow(src), result.nextHopRow(src) + numNodes, UNREACHABLE_ROUTE);
+        result.distanceRow(src)[src] = 0;
+        result.nextHopRow(src)[src] = src;
+    });
+
+    if (result.backupNextHops.empty())
+        return result;
+    // Alternates only need the hop counts and first hops of a source, whichever shortest routes they came from
+    threadPool->parallelFor(numNodes, [&](int src) {
+        if (!routes.isRoutedSource(src))
+            return;
+        std::vector<int> dist(numNodes), firstHop(numNodes), alternate;
+        const uint16_t *distances = result.distanceRow(src);
+        const uint16_t *nextHops = result.nextHopRow(src);
+        for (int i = 0; i < numNodes; ++i) {
+            dist[i] = distances[i] == UNREACHABLE_ROUTE ? INT_MAX : distances[i];
+            firstHop[i] = nextHops[i] == UNREACHABLE_ROUTE ? -1 : nextHops[i];
+        }
+        graph.alternateFirstHops(src, dist, firstHop, alternate);
+        uint16_t *backupNextHops = result.backupNextHopRow(src);
+        for (int i = 0; i < numNodes; ++i)
+            backupNextHops[i] = alternate[i] == -1 ? UNREACHABLE_ROUTE : alternate[i];
+    });
+    return result;
+}
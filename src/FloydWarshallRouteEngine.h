@@ -0,0 +1,44 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef FLOYDWARSHALLROUTEENGINE_H_
+#define FLOYDWARSHALLROUTEENGINE_H_
+
+#include "RouteEngine.h"
+
+// Floyd-Warshall over the 16-bit hop-count matrix, blocked into tiles that stay in cache. Each relaxation
+// is a saturating add and a min over a row of a tile (sixteen entries at a time when compiled with AVX2),
+// and the next hop towards the pivot is copied wherever the distance improves. Its cost does not depend on
+// the number of links, unlike that of the searches; benchmarks/route_benchmark compares the two.
+// Among equal-cost routes the next hop may differ from the one the searches pick.
+class FloydWarshallRouteEngine : public RouteEngine {
+
+public:
+   static const int TILE_SIZE = 64;
+
+   const char *getName() const override { return "floydWarshall"; }
+   bool supportsLinkMetric(LinkMetric linkMetric) const override { return linkMetric == HOP_COUNT; }
+   DijkstraAllPairsOutput findAllShortestPaths(const RouteCalculator& routes) const override;
+
+private:
+   // Relaxes the tile of rows iBlock and columns jBlock over the pivots of kBlock
+   static void relaxTile(DijkstraAllPairsOutput& table, int numNodes, int iBlock, int jBlock, int kBlock);
+   // Same for a tile off the pivot row and column, which does not change the tiles it reads. Each row
+   // of the tile then stays in registers while all pivots are applied to it.
+   static void relaxIndependentTile(DijkstraAllPairsOutput& table, int numNodes, int iBlock, int jBlock, int kBlock);
+};
+
+#endif /* FLOYDWARSHALLROUTEENGINE_H_ */
@@ -21,13 +21,25 @@
 #include <cmath>
 #include <queue>
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include "NodeManager.h"
+#include "SpatialGrid.h"
+#include "BitGraph.h"
+#include "RouteEngine.h"
 #include <random>
 
 using namespace inet;
 
 Define_Module(NodeManager);
 
+static const char *routeUpdatePhaseNames[] = { "positions", "buildGraph", "topology", "allPairs", "destinations", "snapshot" };
+
+
+NodeManager::~NodeManager(){
+    delete routeCalculator;
+    delete routeThreadPool;
+}
 
 void NodeManager::initialize(int stage){
     if (stage == INITSTAGE_LOCAL){
@@ -35,7 +47,68 @@ void NodeManager::initialize(int stage){
         groundStationRange = par("groundStationRange");
         destAddrs = par("destAddrs").stringValue();
         routeUpdateInterval = par("routeUpdateInterval");
+        routeUpdateMode = par("routeUpdateMode").stdstringValue();
+        if (routeUpdateMode != "periodic" && routeUpdateMode != "eventDriven" && routeUpdateMode != "adaptive")
+            throw cRuntimeError("Unknown routeUpdateMode '%s'", routeUpdateMode.c_str());
+        minRouteUpdateInterval = par("minRouteUpdateInterval");
+        maxRouteUpdateInterval = par("maxRouteUpdateInterval");
+        targetLinkChurn = par("targetLinkChurn");
+        adaptiveRouteUpdateInterval = routeUpdateInterval;
+        routeUpdateIntervalSignal = registerSignal("routeUpdateInterval");
+        linkChurnSignal = registerSignal("linkChurn");
+        for (int phase = 0; phase < NUM_ROUTE_UPDATE_PHASES; ++phase)
+            routeUpdatePhaseSignals[phase] = registerSignal((std::string(routeUpdatePhaseNames[phase]) + "Time").c_str());
+        routeUpdateTimeSignal = registerSignal("routeUpdateTime");
+        routeNodesSignal = registerSignal("routeNodes");
+        routeLinksSignal = registerSignal("routeLinks");
         usableCommunicationRangeRatio = par("usableCommunicationRangeRatio"); // Initialize the usable communication range ratio
+        lazyRouteComputation = par("lazyRouteComputation");
+        int numRouteThreads = par("numRouteThreads");
+        if (numRouteThreads <= 0)
+            numRouteThreads = std::max(1u, std::thread::hardware_concurrency());
+        routeThreadPool = new ThreadPool(numRouteThreads);
+        EV_INFO << "Route calculation uses " << numRouteThreads << " threads." << endl;
+        routeCalculator = new RouteCalculator(routeThreadPool);
+        LinkMetric linkMetric;
+        std::string linkMetricName = par("linkMetric").stdstringValue();
+        if (linkMetricName == "hopCount")
+            linkMetric = HOP_COUNT;
+        else if (linkMetricName == "distance")
+            linkMetric = DISTANCE;
+        else if (linkMetricName == "margin")
+            linkMetric = MARGIN;
+        else
+            throw cRuntimeError("Unknown linkMetric '%s'", linkMetricName.c_str());
+        routeCalculator->linkMetric = linkMetric;
+        routeCalculator->linkWeightLevels = par("linkWeightLevels");
+        if (routeCalculator->linkWeightLevels < 1 || routeCalculator->linkWeightLevels > 0xFFFF)
+            throw cRuntimeError("linkWeightLevels must be between 1 and 65535");
+        routeCalculator->backupRoutes = par("backupRoutes");
+        routeCalculator->pruneComponents = par("pruneUnreachableComponents");
+        std::string routeEngineName = par("routeEngine").stdstringValue();
+        RouteEngine *routeEngine = RouteEngine::create(routeEngineName);
+        if (!routeEngine)
+            throw cRuntimeError("Unknown routeEngine '%s'", routeEngineName.c_str());
+        routeCalculator->setEngine(routeEngine);
+        if (!routeEngine->supportsLinkMetric(linkMetric))
+            throw cRuntimeError("routeEngine \"%s\" does not support linkMetric \"%s\"", routeEngineName.c_str(), linkMetricName.c_str());
+        incrementalRouteUpdates = par("incrementalRouteUpdates");
+        if (incrementalRouteUpdates && linkMetric != HOP_COUNT)
+            throw cRuntimeError("incrementalRouteUpdates requires linkMetric \"hopCount\"");
+        incrementalChangeThreshold = par("incrementalChangeThreshold");
+        std::string positionRecordFile = par("positionRecordFile").stdstringValue();
+        if (!positionRecordFile.empty() && !positionRecorder.open(positionRecordFile))
+            throw cRuntimeError("Cannot create positionRecordFile '%s'", positionRecordFile.c_str());
+        std::string routeTableSnapshotFile = par("routeTableSnapshotFile").stdstringValue();
+        if (!routeTableSnapshotFile.empty() && !routeTableRecorder.open(routeTableSnapshotFile))
+            throw cRuntimeError("Cannot create routeTableSnapshotFile '%s'", routeTableSnapshotFile.c_str());
+        routeTableSnapshotAllPairs = par("routeTableSnapshotAllPairs");
+        std::string packetTraceFile = par("packetTraceFile").stdstringValue();
+        bool packetTraceCompression = par("packetTraceCompression");
+        if (packetTraceCompression && !PacketTraceSink::supportsCompression())
+            throw cRuntimeError("packetTraceCompression needs a build with WITH_ZLIB, see makefrag");
+        if (!packetTraceFile.empty() && !packetTrace.open(packetTraceFile, packetTraceCompression))
+            throw cRuntimeError("Cannot create packetTraceFile '%s'", packetTraceFile.c_str());
         initializeNetworkMsg = new cMessage("InitializeNetwork");
         scheduleAt(simTime(), initializeNetworkMsg);
         buildGraphMsg = new cMessage("BuildGraph");
@@ -52,45 +125,187 @@ void NodeManager::initialize(int stage){
             // Log the original communication range
             EV_INFO << "Using the original Communication Range: " << communicationRange/1000.0 << " km." << endl; 
         }   
+        routeCalculator->communicationRange = communicationRange;
+        routeCalculator->groundStationRange = groundStationRange;
     }
 }
 
 void NodeManager::recalculateRoutes() {
-    positionOfRegisteredNodes.clear();
-    ipAddressesOfRegisteredNodes.clear();
-    std::vector<cModule *> activeNodes = checkActiveNodesAtTime();//working
-    std::vector<Coord> activeNodesPosition = checkPositionsofActiveNodesAtTime(); //working
-    std::vector<L3Address> activeNodesAddress = checkIPAddressofActiveNodesAtTime(); //working
-    std::vector<L3Address> destAddresses;
-    if (L3AddressResolver().tryResolve(destAddrs.c_str(), destAddress)) {
-        EV << " Destination address is: " << destAddress << endl; //working
-        destAddresses.push_back(destAddress);
-    } else {
-        EV << " Destination address not found! " << endl;
+    RouteUpdateClock clock;
+    writeRouteTableSnapshot();
+    clock.lap(SNAPSHOT_PHASE);
+    std::vector<Coord>& activeNodesPosition = checkPositionsofActiveNodesAtTime(); //working
+    std::vector<L3Address>& activeNodesAddress = checkIPAddressofActiveNodesAtTime(); //working
+    int numNodes = activeNodesAddress.size();
+    // Ground stations that cannot be resolved yet are retried on the next route update
+    std::vector<L3Address> destinations = destAddresses;
+    if (destinations.empty()) {
+        bool allResolved = true;
+        cStringTokenizer tokenizer(destAddrs.c_str());
+        while (tokenizer.hasMoreTokens()) {
+            const char *token = tokenizer.nextToken();
+            L3Address address;
+            if (L3AddressResolver().tryResolve(token, address)) {
+                EV << " Destination address is: " << address << endl;
+                destinations.push_back(address);
+            } else {
+                EV << " Destination address " << token << " not found! " << endl;
+                allResolved = false;
+            }
+        }
+        if (allResolved)
+            destAddresses = destinations;
+    }
+    destIndices.clear();
+    isDestinationNode.assign(numNodes, false);
+    for (const L3Address& address : destinations) {
+        int destIdx = findNodeIndex(address);
+        if (destIdx >= 0 && !isDestinationNode[destIdx]) {
+            isDestinationNode[destIdx] = true;
+            destIndices.push_back(destIdx);
+        }
+    }
+    std::sort(destIndices.begin(), destIndices.end());
+    EV << "Number of registered ground stations: " << destIndices.size() << endl;
+    routePositions.resize(numNodes);
+    for (int i = 0; i < numNodes; ++i)
+        routePositions[i] = { activeNodesPosition[i].x, activeNodesPosition[i].y, activeNodesPosition[i].z };
+    if (positionRecorder.isOpen()) {
+        recordedAddresses.resize(numNodes);
+        for (int i = 0; i < numNodes; ++i)
+            recordedAddresses[i] = ipv4AddressValue(activeNodesAddress[i]);
+        PositionSnapshotHeader header = {};
+        header.simTime = simTime().dbl();
+        header.communicationRange = routeCalculator->communicationRange;
+        header.groundStationRange = routeCalculator->groundStationRange;
+        header.linkMetric = routeCalculator->linkMetric;
+        header.linkWeightLevels = routeCalculator->linkWeightLevels;
+        positionRecorder.write(header, routePositions, recordedAddresses, destIndices);
     }
-    int destIdx = std::distance(activeNodesAddress.begin(), std::find(activeNodesAddress.begin(), activeNodesAddress.end(), destAddress));
-    EV << "Destination Index is: " << destIdx << endl;//working
-    destPosition = activeNodesPosition[destIdx];
-    //EV << "Destination Position is: " << destPosition << endl;
-    std::vector<std::vector<int>> adjacencyMatrix = BuildGraph(activeNodesPosition, communicationRange, destIdx, groundStationRange);//working 
+    clock.lap(POSITIONS_PHASE);
+    AdjacencyLists links = routeCalculator->buildGraph(routePositions, destIndices);
+    clock.lap(BUILD_GRAPH_PHASE);
     //destAddresses.push_back(ipAddressesOfRegisteredNodes[0]);
-    printGraph(adjacencyMatrix);//working
-    allShortetPaths.distances.clear();
-    allShortetPaths.nextHops.clear();
-    allShortPathsToDestinations.distances.clear();
-    allShortPathsToDestinations.nextHops.clear();
-    allShortetPaths = findAllShortestPaths(adjacencyMatrix,activeNodesAddress);
-    allShortPathsToDestinations = findAllShortestPathsToDestination(adjacencyMatrix,activeNodesAddress,destAddresses);//working
-    // printHopsforAllPaths();
-    printRoutingTable(activeNodesAddress, destAddresses, allShortPathsToDestinations);
+    allShortPathsToDestinations.clear();
+    BitGraph graph;
+    graph.assign(links);
+    // Repair the previous epoch's routes if the node set is unchanged and only a few links differ
+    std::vector<std::pair<int, int>> changedEdges;
+    linkChurn = -1;
+    if ((incrementalRouteUpdates || routeUpdateMode == "adaptive") && routeEpoch > 0 && activeNodesAddress == routeGraphAddresses) {
+        graph.diff(routeCalculator->getGraph(), changedEdges);
+        linkChurn = changedEdges.size();
+        emit(linkChurnSignal, linkChurn);
+    }
+    bool incremental = incrementalRouteUpdates && linkChurn >= 0 && linkChurn <= incrementalChangeThreshold * std::max(1L, routeCalculator->getGraph().numEdges());
+    if (incrementalRouteUpdates && linkChurn >= 0) {
+        EV << "Links changed since last update: " << linkChurn << (incremental ? ", repairing routes" : ", recomputing all routes") << endl;
+    }
+    if (incremental) {
+        previousRoutedSources.resize(numNodes);
+        for (int i = 0; i < numNodes; ++i)
+            previousRoutedSources[i] = routeCalculator->isRoutedSource(i);
+    }
+    routeCalculator->setGraph(std::move(graph), links, destIndices);
+    routeGraphAddresses = activeNodesAddress;
+    ++routeEpoch;
+    routeEpochStart = simTime();
+    clock.lap(TOPOLOGY_PHASE);
+    if (incremental) {
+        updateRoutesIncrementally(changedEdges);
+    }
+    else if (lazyRouteComputation) {
+        // Rows are computed by findNextHop on first use in this epoch. Rows of earlier epochs are told apart by
+        // routeRowEpoch, so the table is only allocated again when the number of nodes changes.
+        if (allShortetPaths.numColumns != numNodes || (int)routeRowEpoch.size() != numNodes) {
+            allShortetPaths.reset(numNodes, numNodes, routeCalculator->backupRoutes);
+            routeRowEpoch.assign(numNodes, -1);
+        }
+    }
+    else {
+        allShortetPaths = routeCalculator->findAllShortestPaths();
+    }
+    clock.lap(ALL_PAIRS_PHASE);
+    allShortPathsToDestinations = routeCalculator->findAllShortestPathsToDestination(destIndices, nearestDestination);
+    clock.lap(DESTINATIONS_PHASE);
+    recordRouteUpdate(clock, numNodes, routeCalculator->getGraph().numEdges());
+}
+
+void NodeManager::recordRouteUpdate(const RouteUpdateClock& clock, int numNodes, long numLinks) {
+    double updateTime = 0;
+    for (int phase = 0; phase < NUM_ROUTE_UPDATE_PHASES; ++phase) {
+        emit(routeUpdatePhaseSignals[phase], clock.phaseTime[phase]);
+        routeUpdatePhaseTotals[phase] += clock.phaseTime[phase];
+        updateTime += clock.phaseTime[phase];
+    }
+    emit(routeUpdateTimeSignal, updateTime);
+    emit(routeNodesSignal, (long)numNodes);
+    emit(routeLinksSignal, numLinks);
+    ++numRouteUpdates;
+}
+
+void NodeManager::writeRouteTableSnapshot() {
+    if (!routeTableRecorder.isOpen() || routeEpoch == 0)
+        return;
+    recordedAddresses.resize(routeGraphAddresses.size());
+    for (size_t i = 0; i < routeGraphAddresses.size(); ++i)
+        recordedAddresses[i] = ipv4AddressValue(routeGraphAddresses[i]);
+    // In lazy mode only the rows computed or carried over into this epoch are valid, the others are written as unreachable
+    std::vector<uint8_t> computedRows;
+    if (lazyRouteComputation) {
+        computedRows.resize(routeRowEpoch.size());
+        for (size_t src = 0; src < routeRowEpoch.size(); ++src)
+            computedRows[src] = routeRowEpoch[src] == routeEpoch;
+    }
+    routeTableRecorder.write(routeEpochStart.dbl(), routeEpoch, recordedAddresses, routeCalculator->getGraph(), nearestDestination,
+            allShortPathsToDestinations, routeTableSnapshotAllPairs ? &allShortetPaths : nullptr, lazyRouteComputation ? &computedRows : nullptr);
+}
+
+void NodeManager::recordPacketReceived(int sourceNodeId, uint32_t sequenceNumber, simtime_t delay, int hopCount) {
+    std::vector<bool>& received = receivedSequenceNumbers[sourceNodeId];
+    if (sequenceNumber >= received.size())
+        received.resize(std::max<size_t>(sequenceNumber + 1, 2 * received.size()), false);
+    if (received[sequenceNumber]) {
+        ++duplicatePackets;
+        return;
+    }
+    received[sequenceNumber] = true;
+    ++packetsReceived;
+    endToEndDelayHistogram.collect(delay.dbl());
+    deliveredHopCountHistogram.collect(hopCount);
+}
+
+void NodeManager::finish() {
+    double totalTime = 0;
+    for (int phase = 0; phase < NUM_ROUTE_UPDATE_PHASES; ++phase) {
+        recordScalar((std::string(routeUpdatePhaseNames[phase]) + "TotalTime").c_str(), routeUpdatePhaseTotals[phase], "s");
+        totalTime += routeUpdatePhaseTotals[phase];
+    }
+    recordScalar("routeUpdates", numRouteUpdates);
+    recordScalar("routeUpdateTotalTime", totalTime, "s");
+    recordScalar("routeUpdatesPerSecond", totalTime > 0 ? numRouteUpdates / totalTime : 0);
+    recordScalar("packetsSent", packetsSent);
+    recordScalar("packetsReceived", packetsReceived);
+    recordScalar("duplicatePackets", duplicatePackets);
+    recordScalar("packetDeliveryRatio", packetsSent > 0 ? (double)packetsReceived / packetsSent : 0);
+    endToEndDelayHistogram.recordAs("endToEndDelay", "s");
+    deliveredHopCountHistogram.recordAs("deliveredHopCount");
+    positionRecorder.close();
+    writeRouteTableSnapshot();
+    routeTableRecorder.close();
+    packetTrace.close();
 }
 
 void NodeManager::registerClient(cModule* node){
     //check if the node is already registered to avoid duplicacy
-    auto it = std::find(registeredNodes.begin(), registeredNodes.end(), node);
+    auto it = findRegisteredNode(node);
     if (it == registeredNodes.end()){
        EV << "Registering Client " << node->getIndex() << " ....\n"; //working
-       registeredNodes.push_back(node);
+       RegisteredNode record;
+       record.module = node;
+       record.mobility = check_and_cast<IMobility*>(node->getSubmodule("mobility"));
+       registeredNodes.push_back(record);
+       registeredNodesChanged = true;
        EV << "Number of Nodes: " << registeredNodes.size() << endl; //working
        EV << "Client " << node->getIndex() << " Registered!\n" << endl; //working
    }else{
@@ -100,12 +315,13 @@ void NodeManager::registerClient(cModule* node){
 
 void NodeManager::deregisterClient(cModule* node) {
    EV << "Deregistering Client " << node->getIndex() << " ....\n";
-   auto it = std::find(registeredNodes.begin(), registeredNodes.end(), node);
+   auto it = findRegisteredNode(node);
    if (it != registeredNodes.end()) {
           registeredNodes.erase(it);
+          registeredNodesChanged = true;
           EV << "Client " << node->getIndex() << " Deregistered!\n";
           // Check if the node is still present after deregistration
-        it = std::find(registeredNodes.begin(), registeredNodes.end(), node);
+        it = findRegisteredNode(node);
         
         if (it != registeredNodes.end()) {
             EV << "Client " << node->getIndex() << " is still present after deregistration.\n";
@@ -123,7 +339,12 @@ void NodeManager::deregisterClient(cModule* node) {
    } 
 }
 
-std::vector<cModule *>& NodeManager::checkActiveNodesAtTime()
+std::vector<NodeManager::RegisteredNode>::iterator NodeManager::findRegisteredNode(cModule* node)
+{
+    return std::find_if(registeredNodes.begin(), registeredNodes.end(), [node](const RegisteredNode& record) { return record.module == node; });
+}
+
+std::vector<NodeManager::RegisteredNode>& NodeManager::checkActiveNodesAtTime()
 {
     return registeredNodes;
 }
@@ -131,21 +352,31 @@ std::vector<cModule *>& NodeManager::checkActiveNodesAtTime()
 std::vector<Coord>& NodeManager::checkPositionsofActiveNodesAtTime()
 {
     int registeredNodesSize = registeredNodes.size();
+    positionOfRegisteredNodes.resize(registeredNodesSize);
     for (int i = 0; i < registeredNodesSize; ++i) {
-        IMobility* mobility = check_and_cast<IMobility*>(registeredNodes[i]->getSubmodule("mobility"));
-        Coord position = mobility->getCurrentPosition();
-        positionOfRegisteredNodes.push_back(position);
+        positionOfRegisteredNodes[i] = registeredNodes[i].mobility->getCurrentPosition();
     }
     return positionOfRegisteredNodes;
 }
 
 std::vector<L3Address>& NodeManager::checkIPAddressofActiveNodesAtTime()
 {
+    // Addresses only change when nodes register or deregister
+    if (!registeredNodesChanged)
+        return ipAddressesOfRegisteredNodes;
     int registeredNodesSize = registeredNodes.size();
+    if (registeredNodesSize >= UNREACHABLE_ROUTE)
+        throw cRuntimeError("Route tables support at most %d nodes", UNREACHABLE_ROUTE - 1);
+    ipAddressesOfRegisteredNodes.resize(registeredNodesSize);
+    addressToIndex.clear();
     for (int i = 0; i < registeredNodesSize; ++i) {
-        L3Address address = L3AddressResolver().addressOf(registeredNodes[i]);
-        ipAddressesOfRegisteredNodes.push_back(address);
+        // Interfaces get their addresses after registration, so each address is resolved on first use
+        if (registeredNodes[i].address.isUnspecified())
+            registeredNodes[i].address = L3AddressResolver().addressOf(registeredNodes[i].module);
+        ipAddressesOfRegisteredNodes[i] = registeredNodes[i].address;
+        addressToIndex.emplace(ipAddressesOfRegisteredNodes[i], i); // keeps the first index of duplicate addresses
     }
+    registeredNodesChanged = false;
     return ipAddressesOfRegisteredNodes;
 }
 
@@ -153,14 +384,8 @@ void NodeManager::handleMessage(cMessage* msg) {
     //std::vector<std::vector<int>> adjacencyMatrix = std::vector<std::vector<int>>(registeredNodes.size(), std::vector<int>(registeredNodes.size(), 0));
     if (msg == initializeNetworkMsg){
         EV << "Number of Nodes: " << registeredNodes.size() << endl; //working
-        int registeredNodesSize = registeredNodes.size();
-        for (int i = 0; i < registeredNodesSize; ++i) {
-             IMobility* mobility = check_and_cast<IMobility*>(registeredNodes[i]->getSubmodule("mobility"));
-             Coord position = mobility->getCurrentPosition();
-             L3Address address = L3AddressResolver().addressOf(registeredNodes[i]);
-             positionOfRegisteredNodes.push_back(position);
-             ipAddressesOfRegisteredNodes.push_back(address);
-        }
+        checkPositionsofActiveNodesAtTime();
+        checkIPAddressofActiveNodesAtTime();
 
     }
     if (msg == buildGraphMsg){
@@ -196,7 +421,7 @@ void NodeManager::handleMessage(cMessage* msg) {
         // scheduleAt(simTime() + routeUpdateInterval, buildGraphMsg);
         // Recalculate routes
         recalculateRoutes();  
-        scheduleAt(simTime() + routeUpdateInterval, buildGraphMsg);
+        scheduleAt(simTime() + nextRouteUpdateDelay(), buildGraphMsg);
     }
      else {
        EV << "Other Message received: " << msg << endl;
@@ -204,165 +429,116 @@ void NodeManager::handleMessage(cMessage* msg) {
     }
 }
 
-std::vector<std::vector<int>> NodeManager::BuildGraph(std::vector<Coord>& position, double communicationRange, int destIdx, double groundStationRange){
-    int numNodes = position.size();
-    // Coord destPosition = position[destIdx];
-    std::vector<std::vector<int>> adjacencyMatrix(numNodes, std::vector<int>(numNodes, 0));
-      for (int i = 0; i < numNodes; ++i) {
-          for (int j = i + 1; j < numNodes; ++j) {
-              if (i != j){
-              double distance = position[i].distance(position[j]);
-              // Determine the range to use based on the destination node
-              double comm_range = (i == destIdx || j == destIdx) ? groundStationRange : communicationRange;
-              if (distance <= comm_range) {
-                  adjacencyMatrix[i][j] = 1;  // 1 indicates edge
-                  adjacencyMatrix[j][i] = 1;
-              }
-              else {
-                  adjacencyMatrix[i][j] = 0;
-                  adjacencyMatrix[j][i] = 0;
-              }
-          }
-      }
-   }
-      return adjacencyMatrix;
+simtime_t NodeManager::nextRouteUpdateDelay(){
+    simtime_t delay = routeUpdateInterval;
+    if (routeUpdateMode == "eventDriven") {
+        predictLinkChanges();
+        delay = linkChangeTimes.empty() ? maxRouteUpdateInterval : linkChangeTimes.top() - simTime();
+        EV << "Next predicted link change in " << delay << endl;
+        // Updating no sooner than minRouteUpdateInterval picks up the links that change until then together
+        delay = std::min(maxRouteUpdateInterval, std::max(minRouteUpdateInterval, delay));
+    }
+    else if (routeUpdateMode == "adaptive") {
+        if (linkChurn >= 0) {
+            // Churn grows roughly in proportion to the interval. Move towards the interval that would
+            // meet targetLinkChurn, damped to at most a factor of two per update.
+            double factor = linkChurn > 0 ? std::sqrt(targetLinkChurn / linkChurn) : 2.0;
+            factor = std::min(2.0, std::max(0.5, factor));
+            adaptiveRouteUpdateInterval = std::min(maxRouteUpdateInterval, std::max(minRouteUpdateInterval, adaptiveRouteUpdateInterval * factor));
+        }
+        EV << "Link churn " << linkChurn << ", next route update in " << adaptiveRouteUpdateInterval << endl;
+        delay = adaptiveRouteUpdateInterval;
+    }
+    emit(routeUpdateIntervalSignal, delay);
+    return delay;
 }
 
-DijkstraAllPairsOutput NodeManager::findAllShortestPaths(std::vector<std::vector<int>>& adjacencyMatrix, std::vector<L3Address>& ipAddresses){
-    int numNodes =  adjacencyMatrix.size();
-    DijkstraAllPairsOutput result;
-    result.distances = std::vector<std::vector<int>>(numNodes, std::vector<int>(numNodes, INT_MAX));
-    result.nextHops = std::vector<std::vector<L3Address>>(numNodes, std::vector<L3Address>(numNodes));
-    
-    for (int src = 0; src < numNodes; ++src) {
-        std::vector<int> dist(numNodes, INT_MAX);
-        std::vector<int> previous(numNodes, -1);
-        std::vector<bool> visited(numNodes, false);
-
-        dist[src] = 0;
-
-        using Pair = std::pair<int, int>; // Pair(distance, vertex)
-        std::priority_queue<Pair, std::vector<Pair>, std::greater<Pair>> Q;
-
-        Q.push({ 0, src });
-
-        while (!Q.empty()) {
-            int u = Q.top().second;
-            Q.pop();
-
-            if (visited[u]) continue;
-            visited[u] = true;
-
-            for (int v = 0; v < numNodes; v++) {
-                if (adjacencyMatrix[u][v] && !visited[v]) {
-                    int alt = dist[u] + adjacencyMatrix[u][v];
-                    if (alt < dist[v]) {
-                        dist[v] = alt;
-                        previous[v] = u;
-                        Q.push({ dist[v], v });
-                    }
-                }
-            }
-        }
+// Time from now until two nodes moving at constant velocity cross the given range, -1 if never
+static double predictRangeCrossing(const Coord& positionA, const Coord& velocityA, const Coord& positionB, const Coord& velocityB, double range){
+    Coord p = positionB - positionA;
+    Coord v = velocityB - velocityA;
+    // Solve |p + v t| = range for t
+    double a = v * v;
+    double b = 2 * (p * v);
+    double c = p * p - range * range;
+    double discriminant = b * b - 4 * a * c;
+    if (a == 0 || discriminant < 0)
+        return -1;
+    double root = std::sqrt(discriminant);
+    if (c <= 0)
+        return (-b + root) / (2 * a); // in range: the later root is when the link breaks
+    double t = (-b - root) / (2 * a); // out of range: the earlier root is when the link forms
+    return t > 0 ? t : -1;
+}
 
-        for (int i = 0; i < numNodes; i++) {
-            result.distances[src][i] = dist[i];
-            if (i == src) {
-                result.nextHops[src][i] = ipAddresses[i];
-            }
-            else if (previous[i] != -1) {
-                int nextHop = i;
-                while (previous[nextHop] != src && previous[nextHop] != -1) {
-                    nextHop = previous[nextHop];
-                }
-                result.nextHops[src][i] = ipAddresses[nextHop];
-            }
+void NodeManager::predictLinkChanges(){
+    std::vector<Coord>& position = positionOfRegisteredNodes;
+    int numNodes = position.size();
+    std::vector<Coord> velocity(numNodes);
+    double maxSpeed = 0;
+    for (int i = 0; i < numNodes; ++i) {
+        velocity[i] = registeredNodes[i].mobility->getCurrentVelocity();
+        maxSpeed = std::max(maxSpeed, velocity[i].length());
+    }
+    double horizon = maxRouteUpdateInterval.dbl();
+    linkChangeTimes = decltype(linkChangeTimes)();
+    auto predict = [&](int i, int j, double range) {
+        double t = predictRangeCrossing(position[i], velocity[i], position[j], velocity[j], range);
+        if (t >= 0 && t <= horizon)
+            linkChangeTimes.push(simTime() + t);
+    };
+    // Within the horizon no pair can close more than 2 * maxSpeed * horizon, so pairs outside
+    // adjacent cells of that enlarged size can neither break nor form a link
+    SpatialGrid<Coord> grid(position, communicationRange + 2 * maxSpeed * horizon);
+    grid.forEachCandidatePair([&](int i, int j) {
+        if (!isDestinationNode[i] && !isDestinationNode[j])
+            predict(i, j, communicationRange);
+    });
+    for (int destIdx : destIndices) {
+        for (int j = 0; j < numNodes; ++j) {
+            if (!isDestinationNode[j])
+                predict(destIdx, j, groundStationRange);
         }
     }
-    return result;
-
 }
 
-DijkstraAllPairsOutput NodeManager::findAllShortestPathsToDestination(std::vector<std::vector<int>>& adjacencyMatrix, std::vector<L3Address>& ipAddresses, std::vector<L3Address>& destinationIPAddresses){
-    int numNodes =  adjacencyMatrix.size();
-    int destSize = destinationIPAddresses.size();
-    DijkstraAllPairsOutput result;
-    result.distances = std::vector<std::vector<int>>(numNodes, std::vector<int>(numNodes, INT_MAX));
-    result.nextHops = std::vector<std::vector<L3Address>>(numNodes, std::vector<L3Address>(numNodes));
-
-    
-    for (int src = 0; src < numNodes; ++src) {
-        std::vector<int> dist(numNodes, INT_MAX);
-        std::vector<int> previous(numNodes, -1);
-        std::vector<bool> visited(numNodes, false);
-        std::vector<L3Address> destinationIPAddressesTemp = destinationIPAddresses;
-        dist[src] = 0;
-
-        using Pair = std::pair<int, int>; // Pair(distance, vertex)
-        std::priority_queue<Pair, std::vector<Pair>, std::greater<Pair>> Q;
-
-        Q.push({ 0, src });
-
-        while (!Q.empty()) {
-            int u = Q.top().second;
-            Q.pop();
-
-            if (visited[u]) continue;
-            visited[u] = true;
-
-            // Check for early termination condition
-            auto it = std::find(destinationIPAddressesTemp.begin(), destinationIPAddressesTemp.end(), ipAddresses[u]);
-            if (it != destinationIPAddressesTemp.end()) {
-                destinationIPAddressesTemp.erase(it);
-                if (destinationIPAddressesTemp.empty()) {
-                    break;  // All desired destinations have been found
-                }
-            }
-
-            for (int v = 0; v < numNodes; v++) {
-                if (adjacencyMatrix[u][v] && !visited[v]) {
-                    int alt = dist[u] + adjacencyMatrix[u][v];
-                    if (alt < dist[v]) {
-                        dist[v] = alt;
-                        previous[v] = u;
-                        Q.push({ dist[v], v });
-                    }
-                }
-            }
+void NodeManager::updateRoutesIncrementally(const std::vector<std::pair<int, int>>& changedEdges){
+    const BitGraph& routeGraph = routeCalculator->getGraph();
+    int numNodes = routeGraph.size();
+    std::atomic<int> repairedRows(0);
+    routeThreadPool->parallelFor(numNodes, [&](int src) {
+        // In lazy mode only rows computed in the previous epoch can be carried over
+        if (lazyRouteComputation && routeRowEpoch[src] != routeEpoch - 1)
+            return;
+        bool affected = routeCalculator->isRouteRowAffected(src, previousRoutedSources[src], allShortetPaths.distanceRow(src), changedEdges);
+        if (!affected) {
+            if (lazyRouteComputation)
+                routeRowEpoch[src] = routeEpoch;
         }
-
-        // Storing results only for specific destinations
-        for (int j = 0; j < destSize; ++j) {
-            int destIdx = std::distance(ipAddresses.begin(), std::find(ipAddresses.begin(), ipAddresses.end(), destinationIPAddresses[j]));
-            
-            result.distances[src][j] = dist[destIdx];
-            if (previous[destIdx] != -1) {
-                int nextHop = destIdx;
-                while (previous[nextHop] != src && previous[nextHop] != -1) {
-                    nextHop = previous[nextHop];
-                }
-                result.nextHops[src][j] = ipAddresses[nextHop];
-            } else {
-                result.nextHops[src][j] = ipAddresses[destIdx];
-            }
+        else if (lazyRouteComputation) {
+            routeRowEpoch[src] = -1;
         }
-    }
-    return result;
+        else {
+            routeCalculator->findShortestPathsFromSource(src, allShortetPaths.distanceRow(src), allShortetPaths.nextHopRow(src), allShortetPaths.backupNextHopRow(src));
+            ++repairedRows;
+        }
+    });
+    EV << "Repaired routes of " << repairedRows << " sources" << endl;
 }
 
 
- void NodeManager::printRoutingTable(std::vector<L3Address>& ipAddresses, std::vector<L3Address>& destinationIPAddresses, DijkstraAllPairsOutput result){
-    EV << "Routing Table:" << endl;
-    EV << "Source IP | Destination IP | Next Hop IP | Hop Count" << endl;
-    int ipAddressesSize = ipAddresses.size();
-    for (int i = 0; i < ipAddressesSize; i++){
-        int destinationIPAddressesSize = destinationIPAddresses.size();
-        for(int j = 0; j < destinationIPAddressesSize; ++j){
-            EV << ipAddresses[i] << " | " << destinationIPAddresses[j] << " | " << result.nextHops[i][j] << " | " << result.distances[i][j] << endl;
-        }
-    }
-  }
 
+ int NodeManager::findNodeIndex(const L3Address& address) const
+ {
+    auto it = addressToIndex.find(address);
+    return it != addressToIndex.end() ? it->second : -1;
+ }
+
+ bool NodeManager::isGroundStation(const L3Address& address) const
+ {
+    int index = findNodeIndex(address);
+    return index >= 0 && index < (int)isDestinationNode.size() && isDestinationNode[index];
+ }
 
  L3Address NodeManager::findNextHop(L3Address currentNodeAddress, L3Address destinationAddress)
  {
@@ -373,13 +549,25 @@ DijkstraAllPairsOutput NodeManager::findAllShortestPathsToDestination(std::vecto
      //EV << "Current Node Address is: " << currentNodeAddress << "\n"; //working
      L3Address nextHopAddress;
 
-    int srcIdx = std::distance(ipAddressesOfRegisteredNodes.begin(), std::find(ipAddressesOfRegisteredNodes.begin(), ipAddressesOfRegisteredNodes.end(), currentNodeAddress)); 
+    int srcIdx = findNodeIndex(currentNodeAddress);
     //EV << "Source Index is: " << srcIdx << endl;//working
-    int destIdx = std::distance(ipAddressesOfRegisteredNodes.begin(), std::find(ipAddressesOfRegisteredNodes.begin(), ipAddressesOfRegisteredNodes.end(), destinationAddress)); 
+    int destIdx = findNodeIndex(destinationAddress);
     //EV << "Destination Index is: " << destIdx << endl;//working
-    int ipAddressesOfRegisteredNodesSize = ipAddressesOfRegisteredNodes.size();
-    if (srcIdx >= 0 && srcIdx < ipAddressesOfRegisteredNodesSize && destIdx >= 0  && destIdx < ipAddressesOfRegisteredNodesSize){
-        nextHopAddress = allShortetPaths.nextHops[srcIdx][destIdx];
+    if (srcIdx >= 0 && destIdx >= 0){
+        if (routesToNearestDestination(srcIdx, destIdx)) {
+            int nextHop = allShortPathsToDestinations.nextHop(srcIdx, 0);
+            if (nextHop >= 0)
+                nextHopAddress = ipAddressesOfRegisteredNodes[nextHop];
+            EV << "Next Hop Address towards the nearest ground station is: " << nextHopAddress << endl;
+            return nextHopAddress;
+        }
+        // Nodes in different connected components have no route, whether or not the row was computed
+        if (!routeCalculator->isConnected(srcIdx, destIdx))
+            return nextHopAddress;
+        updateRouteRow(srcIdx);
+        int nextHop = allShortetPaths.nextHop(srcIdx, destIdx);
+        if (nextHop >= 0)
+            nextHopAddress = ipAddressesOfRegisteredNodes[nextHop];
         EV << "Next Hop Address is: " << nextHopAddress << endl;
         return nextHopAddress;
     }
@@ -388,15 +576,51 @@ DijkstraAllPairsOutput NodeManager::findAllShortestPathsToDestination(std::vecto
     return inet::L3Address();
  }
 
+ L3Address NodeManager::findNearestDestination(L3Address currentNodeAddress, L3Address destinationAddress) const
+ {
+    int srcIdx = findNodeIndex(currentNodeAddress);
+    int destIdx = findNodeIndex(destinationAddress);
+    if (srcIdx < 0 || destIdx < 0 || destIdx >= (int)isDestinationNode.size() || !isDestinationNode[destIdx] || isDestinationNode[srcIdx])
+        return destinationAddress;
+    uint16_t nearest = nearestDestination[srcIdx];
+    return nearest != UNREACHABLE_ROUTE ? ipAddressesOfRegisteredNodes[nearest] : destinationAddress;
+ }
 
-void NodeManager::printGraph(std::vector<std::vector<int>> graph) {
-     int numNodes =  graph.size();
-     EV << "Graph matrix:" << endl;
-     for (int i = 0; i < numNodes; ++i) {
-         for (int j = 0; j < numNodes; ++j) {
-             EV << graph[i][j] << " ";
-         }
-         EV << endl;
-     }
+ L3Address NodeManager::findBackupNextHop(L3Address currentNodeAddress, L3Address destinationAddress)
+ {
+    int srcIdx = findNodeIndex(currentNodeAddress);
+    int destIdx = findNodeIndex(destinationAddress);
+    if (srcIdx < 0 || destIdx < 0)
+        return L3Address();
+    int backup;
+    if (routesToNearestDestination(srcIdx, destIdx)) {
+        backup = allShortPathsToDestinations.backupNextHop(srcIdx, 0);
+    }
+    else {
+        updateRouteRow(srcIdx);
+        backup = allShortetPaths.backupNextHop(srcIdx, destIdx);
+        if (backup >= 0) {
+            // Rows kept by incremental repair may hold an outdated alternate, so it is checked against the current routes
+            updateRouteRow(backup);
+            if (!routeCalculator->getGraph().hasEdge(srcIdx, backup) || allShortetPaths.distance(backup, destIdx) > allShortetPaths.distance(srcIdx, destIdx))
+                backup = -1;
+        }
+    }
+    L3Address backupAddress = backup >= 0 ? ipAddressesOfRegisteredNodes[backup] : L3Address();
+    EV << "Backup Next Hop Address is: " << backupAddress << endl;
+    return backupAddress;
  }
 
+ void NodeManager::updateRouteRow(int srcIdx)
+ {
+    if (lazyRouteComputation && routeRowEpoch[srcIdx] != routeEpoch) {
+        // First query from this source since the last topology refresh
+        routeCalculator->findShortestPathsFromSource(srcIdx, allShortetPaths.distanceRow(srcIdx), allShortetPaths.nextHopRow(srcIdx), allShortetPaths.backupNextHopRow(srcIdx));
+        routeRowEpoch[srcIdx] = routeEpoch;
+    }
+ }
+
+ bool NodeManager::routesToNearestDestination(int srcIdx, int destIdx) const
+ {
+    return RouteCalculator::routesToNearestDestination(srcIdx, destIdx, isDestinationNode, nearestDestination);
+ }
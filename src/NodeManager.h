@@ -18,9 +18,13 @@
 #define NODEMANAGER_H_
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <queue>
 #include <tuple>
+#include <chrono>
+#include <climits>
+#include <cstdint>
 #include "inet/common/INETDefs.h"
 #include "inet/mobility/contract/IMobility.h"
 #include "inet/common/geometry/common/Coord.h"
@@ -29,6 +33,11 @@
 #include "inet/networklayer/contract/IInterfaceTable.h"
 #include "inet/applications/udpapp/UdpBasicApp.h"
 #include "Dspr.h"
+#include "RouteCalculator.h"
+#include "PositionSnapshot.h"
+#include "RouteTableSnapshot.h"
+#include "PacketTrace.h"
+#include "ThreadPool.h"
 #include "inet/networklayer/common/L3Address.h"
 
 using namespace omnetpp;
@@ -36,9 +45,12 @@ using namespace std;
 using namespace inet;
 
 
-struct DijkstraAllPairsOutput {
-    std::vector<std::vector<int>> distances;
-    std::vector<std::vector<L3Address>> nextHops;
+struct L3AddressHash {
+    size_t operator()(const L3Address& address) const {
+        if (address.getType() == L3Address::IPv4)
+            return std::hash<uint32_t>()(address.toIpv4().getInt());
+        return std::hash<std::string>()(address.str());
+    }
 };
 
 
@@ -54,42 +66,118 @@ protected:
    // std::vector<double> communicationRange;
    double groundStationRange;
    std::string destAddrs;
-   //int destIndex;
+   std::vector<int> destIndices; // registered ground stations of the current route update, ascending
+   std::vector<bool> isDestinationNode;
+   std::vector<uint16_t> nearestDestination; // per node, the ground station of its route in allShortPathsToDestinations
    std::vector<std::tuple<L3Address, L3Address, L3Address, int>> routingTable;
    simtime_t routeUpdateInterval; // Interval for route updates in seconds 
+   std::string routeUpdateMode; // "periodic", "eventDriven" or "adaptive"
+   simtime_t minRouteUpdateInterval;
+   simtime_t maxRouteUpdateInterval;
+   double targetLinkChurn; // links changed per route update the adaptive mode aims for
+   simtime_t adaptiveRouteUpdateInterval;
+   long linkChurn = -1; // links changed by the last route update, -1 if not measured
+   simsignal_t routeUpdateIntervalSignal;
+   simsignal_t linkChurnSignal;
+   std::priority_queue<simtime_t, std::vector<simtime_t>, std::greater<simtime_t>> linkChangeTimes; // predicted link breaks and formations
    double usableCommunicationRangeRatio;
+   bool lazyRouteComputation;
+   long routeEpoch = 0; // incremented on every topology refresh
+   std::vector<long> routeRowEpoch; // epoch in which each row of allShortetPaths was computed (lazy mode)
+   std::vector<bool> previousRoutedSources; // whether each source was routed before the last graph change (incremental mode)
+   std::vector<L3Address> routeGraphAddresses; // node addresses of the current route epoch
+   bool incrementalRouteUpdates;
+   double incrementalChangeThreshold;
+   ThreadPool* routeThreadPool = nullptr; // parallelises graph construction and per-source searches
+   RouteCalculator* routeCalculator = nullptr; // topology of the current route epoch and the searches over it
+   std::vector<Position> routePositions;
+   PositionSnapshotWriter positionRecorder; // open if positionRecordFile is set
+   std::vector<uint32_t> recordedAddresses;
+   RouteTableSnapshotWriter routeTableRecorder; // open if routeTableSnapshotFile is set
+   bool routeTableSnapshotAllPairs;
+   simtime_t routeEpochStart;
+
+   // Wall-clock time of the phases of recalculateRoutes, emitted per update and totalled in finish()
+   enum RouteUpdatePhase { POSITIONS_PHASE, BUILD_GRAPH_PHASE, TOPOLOGY_PHASE, ALL_PAIRS_PHASE, DESTINATIONS_PHASE, SNAPSHOT_PHASE, NUM_ROUTE_UPDATE_PHASES };
+   struct RouteUpdateClock {
+       std::chrono::steady_clock::time_point last = std::chrono::steady_clock::now();
+       double phaseTime[NUM_ROUTE_UPDATE_PHASES] = {};
+       void lap(RouteUpdatePhase phase) { // charges the time since the previous lap to phase
+           auto now = std::chrono::steady_clock::now();
+           phaseTime[phase] += std::chrono::duration<double>(now - last).count();
+           last = now;
+       }
+   };
+   simsignal_t routeUpdatePhaseSignals[NUM_ROUTE_UPDATE_PHASES];
+   simsignal_t routeUpdateTimeSignal;
+   simsignal_t routeNodesSignal;
+   simsignal_t routeLinksSignal;
+   double routeUpdatePhaseTotals[NUM_ROUTE_UPDATE_PHASES] = {};
+   long numRouteUpdates = 0;
+
+   // Delivery of the packets created in the recording windows of all Dspr instances, recorded in finish()
+   long packetsSent = 0;
+   long packetsReceived = 0; // first copies only
+   long duplicatePackets = 0;
+   std::unordered_map<int, std::vector<bool>> receivedSequenceNumbers; // per source node module id
+   cHistogram endToEndDelayHistogram;
+   cHistogram deliveredHopCountHistogram;
+   PacketTraceSink packetTrace; // open if packetTraceFile is set, shared by all Dspr instances
 
    virtual void initialize(int stage) override;
    virtual void handleMessage(cMessage *msg) override;
+   virtual void finish() override;
+   void recordRouteUpdate(const RouteUpdateClock& clock, int numNodes, long numLinks);
+   void writeRouteTableSnapshot(); // tables of the epoch that is ending, including rows computed lazily during it
+   simtime_t nextRouteUpdateDelay();
+   void predictLinkChanges();
+   void updateRouteRow(int srcIdx); // computes the row of srcIdx if lazy mode has not done so in this epoch
+   bool routesToNearestDestination(int srcIdx, int destIdx) const;
 
 public:
-   std::vector<cModule*> registeredNodes;
+   // Per-node state resolved once instead of on every route update
+   struct RegisteredNode {
+       cModule* module = nullptr;
+       IMobility* mobility = nullptr;
+       L3Address address; // resolved on the first route update after network configuration
+   };
+
+   virtual ~NodeManager();
+   long getRouteEpoch() const { return routeEpoch; }
+
+   std::vector<RegisteredNode> registeredNodes;
+   bool registeredNodesChanged = true; // address list and addressToIndex need rebuilding
    std::vector<L3Address> ipAddressesOfRegisteredNodes;
    std::vector<Coord> positionOfRegisteredNodes;
+   std::unordered_map<L3Address, int, L3AddressHash> addressToIndex; // index into ipAddressesOfRegisteredNodes, rebuilt when nodes (de)register
    DijkstraAllPairsOutput allShortetPaths;
-   DijkstraAllPairsOutput allShortPathsToDestinations;
+   DijkstraAllPairsOutput allShortPathsToDestinations; // one column: route to the nearest ground station
    L3Address srcIpAddress;
-   L3Address destAddress;
-   Coord destPosition;
+   std::vector<L3Address> destAddresses; // resolved from destAddrs once
    //Node initialization
    void registerClient(cModule* node); 
    void deregisterClient(cModule* node);
    void recalculateRoutes();
 
    //Finding node details at current time
-   std::vector<cModule*>& checkActiveNodesAtTime();
+   std::vector<RegisteredNode>& checkActiveNodesAtTime();
+   std::vector<RegisteredNode>::iterator findRegisteredNode(cModule* node);
    std::vector<Coord>& checkPositionsofActiveNodesAtTime();
    std::vector<L3Address>& checkIPAddressofActiveNodesAtTime();
 
    //Algorithm
-   std::vector<std::vector<int>> BuildGraph(std::vector<Coord>& position, double communicationRange, int destIdx, double groundStationRange);
-   DijkstraAllPairsOutput findAllShortestPaths(std::vector<std::vector<int>>& adjacencyMatrix, std::vector<L3Address>& ipAddresses);
-   DijkstraAllPairsOutput findAllShortestPathsToDestination(std::vector<std::vector<int>>& adjacencyMatrix, std::vector<L3Address>& ipAddresses, std::vector<L3Address>& destinationIPAddresses);
+   void updateRoutesIncrementally(const std::vector<std::pair<int, int>>& changedEdges);
+   int findNodeIndex(const L3Address& address) const; // -1 if not registered
+   bool isGroundStation(const L3Address& address) const; // one of the destinations of the current route update
+   // Aircraft send packets for any ground station to the nearest reachable one, so they are delivered wherever they reach the ground
+   L3Address findNearestDestination(L3Address currentNodeAddress, L3Address destinationAddress) const;
    L3Address findNextHop(L3Address currentNodeAddress, L3Address destinationAddress);
+   L3Address findBackupNextHop(L3Address currentNodeAddress, L3Address destinationAddress); // unspecified if there is none
 
-   //printing functions
-   void printRoutingTable(std::vector<L3Address>& ipAddresses, std::vector<L3Address>& destinationIPAddresses, DijkstraAllPairsOutput result);
-   void printGraph(std::vector<std::vector<int>> graph);
+   //Delivery statistics
+   void recordPacketSent() { ++packetsSent; }
+   void recordPacketReceived(int sourceNodeId, uint32_t sequenceNumber, simtime_t delay, int hopCount);
+   PacketTraceSink *getPacketTrace() { return packetTrace.isOpen() ? &packetTrace : nullptr; }
 
 };
 
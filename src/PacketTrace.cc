@@ -0,0 +1,126 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstring>
+#include "PacketTrace.h"
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
+
+bool PacketTraceSink::supportsCompression()
+{
+#ifdef WITH_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool PacketTraceSink::open(const std::string& fileName, bool compress)
+{
+    close();
+    if (compress) {
+#ifdef WITH_ZLIB
+        gzipFile = gzopen(fileName.c_str(), "wb1");
+#endif
+        if (!gzipFile)
+            return false;
+    }
+    else {
+        file = fopen(fileName.c_str(), "wb");
+        if (!file)
+            return false;
+    }
+    PacketTraceFileHeader header;
+    memcpy(header.magic, PACKET_TRACE_MAGIC, sizeof(header.magic));
+    header.version = PACKET_TRACE_VERSION;
+    header.recordSize = sizeof(PacketTraceRecord);
+    write(&header, sizeof(header));
+    buffer.reserve(BUFFER_RECORDS);
+    closing = false;
+    writer = std::thread(&PacketTraceSink::writerLoop, this);
+    return true;
+}
+
+void PacketTraceSink::submit()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return pending.size() < MAX_PENDING_BUFFERS; });
+    pending.push_back(std::move(buffer));
+    if (!freeBuffers.empty()) {
+        buffer = std::move(freeBuffers.back());
+        freeBuffers.pop_back();
+    }
+    else {
+        buffer = std::vector<PacketTraceRecord>();
+        buffer.reserve(BUFFER_RECORDS);
+    }
+    changed.notify_all();
+}
+
+void PacketTraceSink::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        changed.wait(lock, [this]() { return !pending.empty() || closing; });
+        if (pending.empty())
+            return;
+        std::vector<PacketTraceRecord> records = std::move(pending.front());
+        pending.pop_front();
+        lock.unlock();
+        write(records.data(), records.size() * sizeof(PacketTraceRecord));
+        records.clear();
+        lock.lock();
+        freeBuffers.push_back(std::move(records));
+        changed.notify_all();
+    }
+}
+
+void PacketTraceSink::write(const void *data, size_t size)
+{
+#ifdef WITH_ZLIB
+    if (gzipFile) {
+        gzwrite((gzFile)gzipFile, data, size);
+        return;
+    }
+#endif
+    fwrite(data, 1, size, file);
+}
+
+void PacketTraceSink::close()
+{
+    if (!isOpen())
+        return;
+    if (!buffer.empty())
+        submit();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    changed.notify_all();
+    writer.join();
+#ifdef WITH_ZLIB
+    if (gzipFile)
+        gzclose((gzFile)gzipFile);
+#endif
+    if (file)
+        fclose(file);
+    file = nullptr;
+    gzipFile = nullptr;
+    buffer = std::vector<PacketTraceRecord>();
+    freeBuffers.clear();
+}
@@ -0,0 +1,94 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef PACKETTRACE_H_
+#define PACKETTRACE_H_
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum PacketTraceEvent : uint8_t { PACKET_SENT, PACKET_ROUTED, PACKET_DROPPED, PACKET_RECEIVED };
+enum PacketTraceInterface : uint8_t { NO_INTERFACE, AIR_TO_AIR, AIR_TO_GROUND };
+
+// One packet event, 32 bytes. The file is a PacketTraceFileHeader followed by records, native-endian;
+// with numpy: numpy.dtype([("simTime", "f8"), ("nodeId", "i4"), ("sourceNodeId", "i4"), ("sequenceNumber", "u4"),
+// ("nextHop", "u4"), ("hopCount", "u2"), ("event", "u1"), ("interface", "u1"), ("reserved", "u4")])
+struct PacketTraceRecord {
+    double simTime; // s
+    int32_t nodeId; // module id of the node reporting the event
+    int32_t sourceNodeId; // packet id as in DsprInfo
+    uint32_t sequenceNumber;
+    uint32_t nextHop; // IPv4 address as integer, 0 if none or not IPv4
+    uint16_t hopCount; // links traversed, including the one the packet is routed to
+    uint8_t event; // PacketTraceEvent
+    uint8_t interface; // PacketTraceInterface
+    uint32_t reserved;
+};
+
+struct PacketTraceFileHeader {
+    char magic[8]; // PACKET_TRACE_MAGIC
+    uint32_t version;
+    uint32_t recordSize; // sizeof(PacketTraceRecord) of the writer
+};
+
+const char PACKET_TRACE_MAGIC[8] = { 'D', 'S', 'P', 'R', 'T', 'R', 'C', '\0' };
+const uint32_t PACKET_TRACE_VERSION = 1;
+
+static_assert(sizeof(PacketTraceRecord) == 32, "packet trace records must stay 32 bytes");
+
+// Collects records in large buffers that a background thread writes out, gzip-compressed if requested
+// (needs a build with WITH_ZLIB). Appending a record is a copy into the current buffer; only handing
+// over a full buffer takes a lock, and it waits only if the writer falls MAX_PENDING_BUFFERS behind.
+class PacketTraceSink {
+
+public:
+   static const size_t BUFFER_RECORDS = 1 << 17; // 4 MiB
+   static const size_t MAX_PENDING_BUFFERS = 16;
+
+   ~PacketTraceSink() { close(); }
+   static bool supportsCompression();
+   bool open(const std::string& fileName, bool compress); // false if the file cannot be created
+   bool isOpen() const { return file != nullptr || gzipFile != nullptr; }
+   void append(const PacketTraceRecord& record) {
+       buffer.push_back(record);
+       if (buffer.size() == BUFFER_RECORDS)
+           submit();
+   }
+   void close(); // writes out all records
+
+private:
+   FILE *file = nullptr;
+   void *gzipFile = nullptr; // gzFile
+   std::vector<PacketTraceRecord> buffer;
+   std::deque<std::vector<PacketTraceRecord>> pending;
+   std::vector<std::vector<PacketTraceRecord>> freeBuffers;
+   std::mutex mutex;
+   std::condition_variable changed;
+   std::thread writer;
+   bool closing = false;
+
+   void submit();
+   void writerLoop();
+   void write(const void *data, size_t size);
+};
+
+#endif /* PACKETTRACE_H_ */
@@ -0,0 +1,58 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <cstring>
+#include "PositionSnapshot.h"
+
+bool PositionSnapshotWriter::open(const std::string& fileName)
+{
+    close();
+    file = fopen(fileName.c_str(), "wb");
+    if (!file)
+        return false;
+    PositionSnapshotFileHeader header;
+    memcpy(header.magic, POSITION_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = POSITION_SNAPSHOT_VERSION;
+    header.snapshotHeaderSize = sizeof(PositionSnapshotHeader);
+    fwrite(&header, sizeof(header), 1, file);
+    return true;
+}
+
+void PositionSnapshotWriter::write(PositionSnapshotHeader header, const std::vector<Position>& positions, const std::vector<uint32_t>& addresses, const std::vector<int>& destIndices)
+{
+    if (!file)
+        return;
+    header.numNodes = positions.size();
+    header.numDestinations = destIndices.size();
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(positions.data(), sizeof(Position), positions.size(), file);
+    fwrite(addresses.data(), sizeof(uint32_t), addresses.size(), file);
+    for (int destIdx : destIndices) {
+        int32_t index = destIdx;
+        fwrite(&index, sizeof(index), 1, file);
+    }
+    static const char padding[8] = {};
+    size_t unpadded = sizeof(header) + positions.size() * (sizeof(Position) + sizeof(uint32_t)) + destIndices.size() * sizeof(int32_t);
+    fwrite(padding, 1, positionSnapshotSize(header) - unpadded, file);
+}
+
+void PositionSnapshotWriter::close()
+{
+    if (file) {
+        fclose(file);
+        file = nullptr;
+    }
+}
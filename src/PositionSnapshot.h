@@ -0,0 +1,77 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef POSITIONSNAPSHOT_H_
+#define POSITIONSNAPSHOT_H_
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "RouteCalculator.h"
+
+// Binary recording of the inputs of every route update, so that graph building and the route engines can be
+// replayed without the simulation (benchmarks/route_replay). All fields are native-endian and naturally aligned,
+// so the file can be memory-mapped and read in place:
+//
+//   PositionSnapshotFileHeader
+//   per route update: PositionSnapshotHeader, Position[numNodes], uint32_t addresses[numNodes],
+//                     int32_t destIndices[numDestinations], zero padding to a multiple of 8 bytes
+struct PositionSnapshotFileHeader {
+    char magic[8]; // POSITION_SNAPSHOT_MAGIC
+    uint32_t version;
+    uint32_t snapshotHeaderSize; // sizeof(PositionSnapshotHeader) of the writer
+};
+
+struct PositionSnapshotHeader {
+    double simTime; // s
+    double communicationRange; // m, after usableCommunicationRangeRatio
+    double groundStationRange; // m
+    uint32_t numNodes;
+    uint32_t numDestinations;
+    int32_t linkMetric; // LinkMetric
+    int32_t linkWeightLevels;
+};
+
+const char POSITION_SNAPSHOT_MAGIC[8] = { 'D', 'S', 'P', 'R', 'P', 'O', 'S', '\0' };
+const uint32_t POSITION_SNAPSHOT_VERSION = 1;
+
+static_assert(sizeof(Position) == 3 * sizeof(double), "Position must be stored without padding");
+static_assert(sizeof(PositionSnapshotHeader) % 8 == 0, "snapshot sections must stay 8-byte aligned");
+
+// Size of one snapshot including its padding
+inline size_t positionSnapshotSize(const PositionSnapshotHeader& header)
+{
+    size_t size = sizeof(PositionSnapshotHeader) + header.numNodes * (sizeof(Position) + sizeof(uint32_t)) + header.numDestinations * sizeof(int32_t);
+    return (size + 7) & ~(size_t)7;
+}
+
+// Appends snapshots to a file through the buffered stdio stream
+class PositionSnapshotWriter {
+
+public:
+   ~PositionSnapshotWriter() { close(); }
+   bool open(const std::string& fileName); // false if the file cannot be created
+   bool isOpen() const { return file != nullptr; }
+   // addresses are IPv4 addresses as integers, 0 for other address types
+   void write(PositionSnapshotHeader header, const std::vector<Position>& positions, const std::vector<uint32_t>& addresses, const std::vector<int>& destIndices);
+   void close();
+
+private:
+   FILE *file = nullptr;
+};
+
+#endif /* POSITIONSNAPSHOT_H_ */
@@ -0,0 +1,256 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cstdlib>
+#include "RouteCalculator.h"
+#include "RouteEngine.h"
+#include "SpatialGrid.h"
+
+RouteCalculator::RouteCalculator(ThreadPool *threadPool) : threadPool(threadPool), engine(new SearchRouteEngine())
+{
+}
+
+RouteCalculator::~RouteCalculator()
+{
+}
+
+void RouteCalculator::setEngine(RouteEngine *engine)
+{
+    this->engine.reset(engine);
+}
+
+AdjacencyLists RouteCalculator::buildGraph(const std::vector<Position>& position, const std::vector<int>& destIndices) const
+{
+    int numNodes = position.size();
+    std::vector<std::vector<std::pair<int, uint16_t>>> rows(numNodes);
+    std::vector<bool> isDestination(numNodes, false);
+    for (int destIdx : destIndices) {
+        if (destIdx >= 0 && destIdx < numNodes)
+            isDestination[destIdx] = true;
+    }
+    // Air-to-air links: only nodes in the same or in adjacent grid cells can be within communicationRange.
+    // Every row is filled by a single thread, so the result does not depend on the number of threads.
+    SpatialGrid<Position> grid(position, communicationRange);
+    threadPool->parallelFor(numNodes, [&](int i) {
+        if (isDestination[i])
+            return;
+        grid.forEachCandidate(i, [&](int j) {
+            double distance = position[i].distance(position[j]);
+            if (!isDestination[j] && distance <= communicationRange)
+                rows[i].push_back({ j, (uint16_t)linkWeight(distance, communicationRange) });
+        });
+    });
+    // Links of the ground stations use the larger groundStationRange, so they are looked up in a second grid of that
+    // cell size. Ground stations do not relay for each other over the air.
+    if (!destIndices.empty()) {
+        SpatialGrid<Position> groundGrid(position, groundStationRange);
+        for (int destIdx : destIndices) {
+            if (destIdx < 0 || destIdx >= numNodes || !rows[destIdx].empty()) // out of range or listed twice
+                continue;
+            groundGrid.forEachCandidate(destIdx, [&](int j) {
+                double distance = position[destIdx].distance(position[j]);
+                if (!isDestination[j] && distance <= groundStationRange) {
+                    uint16_t weight = linkWeight(distance, groundStationRange);
+                    rows[destIdx].push_back({ j, weight });
+                    rows[j].push_back({ destIdx, weight });
+                }
+            });
+        }
+    }
+    threadPool->parallelFor(numNodes, [&](int i) {
+        std::sort(rows[i].begin(), rows[i].end());
+    });
+    AdjacencyLists links;
+    links.assign(rows);
+    return links;
+}
+
+int RouteCalculator::linkWeight(double distance, double range) const
+{
+    if (linkMetric == HOP_COUNT || range <= 0)
+        return 1;
+    if (linkMetric == DISTANCE)
+        return std::max(1, (int)std::ceil(linkWeightLevels * distance / range));
+    // Margin: the less of the range is left, the heavier the link, from 1 at zero distance to linkWeightLevels at the edge
+    int marginLevel = std::max(1, (int)std::ceil(linkWeightLevels * (range - distance) / range));
+    return (linkWeightLevels + marginLevel - 1) / marginLevel;
+}
+
+void RouteCalculator::setGraph(BitGraph&& graph, const AdjacencyLists& links, const std::vector<int>& destIndices)
+{
+    this->graph = std::move(graph);
+    if (linkMetric != HOP_COUNT)
+        weights.assign(links);
+
+    // Union-find over the links, union by size with path halving; the label of a component is its root
+    int numNodes = this->graph.size();
+    component.resize(numNodes);
+    componentSize.assign(numNodes, 1);
+    for (int u = 0; u < numNodes; ++u)
+        component[u] = u;
+    auto find = [&](int u) {
+        while (component[u] != u) {
+            component[u] = component[component[u]];
+            u = component[u];
+        }
+        return u;
+    };
+    std::vector<int> neighbors;
+    for (int u = 0; u < numNodes; ++u) {
+        this->graph.neighbors(u, neighbors);
+        for (int v : neighbors) {
+            if (v < u)
+                continue;
+            int a = find(u), b = find(v);
+            if (a == b)
+                continue;
+            if (componentSize[a] < componentSize[b])
+                std::swap(a, b);
+            component[b] = a;
+            componentSize[a] += componentSize[b];
+        }
+    }
+    for (int u = 0; u < numNodes; ++u)
+        component[u] = find(u);
+    componentHasDestination.assign(numNodes, false);
+    for (int destIdx : destIndices) {
+        if (destIdx >= 0 && destIdx < numNodes)
+            componentHasDestination[component[destIdx]] = true;
+    }
+}
+
+DijkstraAllPairsOutput RouteCalculator::findAllShortestPaths() const
+{
+    return engine->findAllShortestPaths(*this);
+}
+
+void RouteCalculator::findShortestPathsFromSource(int src, uint16_t *distances, uint16_t *nextHops, uint16_t *backupNextHops) const
+{
+    int numNodes = graph.size();
+    if (!isRoutedSource(src)) {
+        std::fill(distances, distances + numNodes, UNREACHABLE_ROUTE);
+        std::fill(nextHops, nextHops + numNodes, UNREACHABLE_ROUTE);
+        if (backupNextHops)
+            std::fill(backupNextHops, backupNextHops + numNodes, UNREACHABLE_ROUTE);
+        distances[src] = 0;
+        nextHops[src] = src;
+        return;
+    }
+    // With unit weights a breadth-first search over packed adjacency rows gives the same distances
+    // and next hops as Dijkstra. Weighted links use a bucket-queue Dijkstra over the same topology;
+    // dist is then the hop count of the minimum-weight path.
+    std::vector<int> dist;
+    std::vector<int> previous;
+    std::vector<int> firstHop;
+    if (linkMetric != HOP_COUNT)
+        weights.search(src, dist, previous, &firstHop);
+    else
+        graph.search(src, dist, previous, &firstHop);
+
+    for (int i = 0; i < numNodes; i++) {
+        distances[i] = dist[i] == INT_MAX ? UNREACHABLE_ROUTE : dist[i];
+        nextHops[i] = firstHop[i] == -1 ? UNREACHABLE_ROUTE : firstHop[i];
+    }
+    if (backupNextHops) {
+        // Alternates are loop-free by hop count, which weighted routes do not follow
+        std::vector<int> alternate;
+        if (linkMetric == HOP_COUNT)
+            graph.alternateFirstHops(src, dist, firstHop, alternate);
+        else
+            alternate.assign(numNodes, -1);
+        for (int i = 0; i < numNodes; i++)
+            backupNextHops[i] = alternate[i] == -1 ? UNREACHABLE_ROUTE : alternate[i];
+    }
+}
+
+bool RouteCalculator::isRouteRowAffected(int src, bool wasRoutedSource, const uint16_t *distances, const std::vector<std::pair<int, int>>& changedEdges) const
+{
+    // A source whose component gained or lost its last destination has no distances that would show it
+    if (isRoutedSource(src) != wasRoutedSource)
+        return true;
+    for (const auto& edge : changedEdges) {
+        int du = distances[edge.first];
+        int dv = distances[edge.second];
+        // Links between nodes at the same hop count are never used by shortest paths. A removed link can only
+        // matter if its ends are one hop apart, an added link whenever their hop counts differ.
+        if (du == dv)
+            continue;
+        if (graph.hasEdge(edge.first, edge.second) || std::abs(du - dv) == 1)
+            return true;
+    }
+    return false;
+}
+
+DijkstraAllPairsOutput RouteCalculator::findAllShortestPathsToDestination(const std::vector<int>& destIndices, std::vector<uint16_t>& nearestDestination) const
+{
+    int numNodes = graph.size();
+    DijkstraAllPairsOutput result;
+    result.reset(numNodes, 1, backupRoutes);
+    nearestDestination.assign(numNodes, UNREACHABLE_ROUTE);
+
+    // Links are symmetric, so a single search started from all ground stations at once gives every node's
+    // hop count towards the nearest of them, and a node's predecessor in that search is its next hop
+    std::vector<int> dist;
+    std::vector<int> previous;
+    std::vector<int> nearestRoot;
+    if (linkMetric != HOP_COUNT)
+        weights.searchNearest(destIndices, dist, previous, nearestRoot);
+    else
+        graph.searchNearest(destIndices, dist, previous, nearestRoot);
+
+    for (int src = 0; src < numNodes; ++src) {
+        if (dist[src] == INT_MAX)
+            continue;
+        result.distanceRow(src)[0] = dist[src];
+        result.nextHopRow(src)[0] = previous[src] != -1 ? previous[src] : src;
+        nearestDestination[src] = nearestRoot[src];
+    }
+    if (!backupRoutes)
+        return result;
+
+    // A neighbor is a loop-free alternate if its own route does not lead back through the node. Routes that also
+    // avoid the primary next hop are preferred, then shorter ones. Following next hops works for any link metric.
+    auto routeAvoids = [&](int from, int avoided) {
+        for (int hop = from; ; hop = previous[hop]) {
+            if (hop == avoided)
+                return false;
+            if (dist[hop] == 0)
+                return true;
+        }
+    };
+    threadPool->parallelFor(numNodes, [&](int src) {
+        if (dist[src] == INT_MAX || dist[src] == 0)
+            return;
+        int primary = previous[src];
+        int backup = -1;
+        bool backupAvoidsPrimary = false;
+        std::vector<int> neighbors;
+        graph.neighbors(src, neighbors);
+        for (int n : neighbors) {
+            if (n == primary || dist[n] == INT_MAX || !routeAvoids(n, src))
+                continue;
+            bool avoidsPrimary = routeAvoids(n, primary);
+            if (backup == -1 || (avoidsPrimary && !backupAvoidsPrimary) || (avoidsPrimary == backupAvoidsPrimary && dist[n] < dist[backup])) {
+                backup = n;
+                backupAvoidsPrimary = avoidsPrimary;
+            }
+        }
+        if (backup != -1)
+            result.backupNextHopRow(src)[0] = backup;
+    });
+    return result;
+}
@@ -0,0 +1,145 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ROUTECALCULATOR_H_
+#define ROUTECALCULATOR_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <climits>
+#include <cmath>
+#include <memory>
+#include "AdjacencyLists.h"
+#include "BitGraph.h"
+#include "WeightedGraph.h"
+#include "ThreadPool.h"
+
+const uint16_t UNREACHABLE_ROUTE = 0xFFFF;
+
+// Route table with one contiguous row-major block per field. Next hops are node indices into the
+// address list of the route update; UNREACHABLE_ROUTE marks missing entries in all fields.
+struct DijkstraAllPairsOutput {
+    int numColumns = 0;
+    std::vector<uint16_t> distances;
+    std::vector<uint16_t> nextHops;
+    std::vector<uint16_t> backupNextHops; // loop-free alternates to nextHops, empty unless requested in reset
+
+    void reset(int numRows, int columns, bool withBackups = false) {
+        numColumns = columns;
+        distances.assign((size_t)numRows * columns, UNREACHABLE_ROUTE);
+        nextHops.assign((size_t)numRows * columns, UNREACHABLE_ROUTE);
+        backupNextHops.assign(withBackups ? (size_t)numRows * columns : 0, UNREACHABLE_ROUTE);
+    }
+    void clear() { reset(0, 0); }
+    size_t memoryBytes() const { return (distances.capacity() + nextHops.capacity() + backupNextHops.capacity()) * sizeof(uint16_t); }
+    uint16_t *distanceRow(int row) { return distances.data() + (size_t)row * numColumns; }
+    const uint16_t *distanceRow(int row) const { return distances.data() + (size_t)row * numColumns; }
+    uint16_t *nextHopRow(int row) { return nextHops.data() + (size_t)row * numColumns; }
+    uint16_t *backupNextHopRow(int row) { return backupNextHops.empty() ? nullptr : backupNextHops.data() + (size_t)row * numColumns; }
+    int distance(int row, int column) const { // INT_MAX if unreachable
+        uint16_t d = distanceRow(row)[column];
+        return d == UNREACHABLE_ROUTE ? INT_MAX : d;
+    }
+    int nextHop(int row, int column) const { // -1 if unreachable
+        uint16_t h = nextHops[(size_t)row * numColumns + column];
+        return h == UNREACHABLE_ROUTE ? -1 : h;
+    }
+    int backupNextHop(int row, int column) const { // -1 if there is none
+        if (backupNextHops.empty())
+            return -1;
+        uint16_t h = backupNextHops[(size_t)row * numColumns + column];
+        return h == UNREACHABLE_ROUTE ? -1 : h;
+    }
+};
+
+// Node position in meters, in the same Cartesian frame as the mobility models
+struct Position {
+    double x, y, z;
+
+    double distance(const Position& other) const {
+        double dx = x - other.x, dy = y - other.y, dz = z - other.z;
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+};
+
+enum LinkMetric { HOP_COUNT, DISTANCE, MARGIN };
+
+class RouteEngine;
+
+// Graph construction and route searches, free of OMNeT++ and INET so that they can also be
+// benchmarked and replayed outside a simulation. Holds the topology of the current route epoch.
+class RouteCalculator {
+
+public:
+   double communicationRange = 0;
+   double groundStationRange = 0; // range of the links of ground stations
+   LinkMetric linkMetric = HOP_COUNT;
+   int linkWeightLevels = 8; // weights of the distance and margin metrics lie in [1, linkWeightLevels]
+   bool backupRoutes = false;
+   bool pruneComponents = false; // skip sources whose connected component holds no destination
+
+   explicit RouteCalculator(ThreadPool *threadPool); // starts with a SearchRouteEngine
+   ~RouteCalculator();
+
+   // Weighted links between nodes within range, found through uniform grids in time linear in the nodes and links.
+   // Ground stations link to every aircraft within groundStationRange.
+   AdjacencyLists buildGraph(const std::vector<Position>& position, const std::vector<int>& destIndices) const;
+   int linkWeight(double distance, double range) const;
+
+   // Makes graph the topology of the searches, with the link weights of the links it was assigned from,
+   // and labels its connected components
+   void setGraph(BitGraph&& graph, const AdjacencyLists& links, const std::vector<int>& destIndices);
+   const BitGraph& getGraph() const { return graph; }
+   size_t graphMemoryBytes() const { return graph.memoryBytes() + weights.memoryBytes(); }
+   ThreadPool *getThreadPool() const { return threadPool; }
+   bool isConnected(int u, int v) const { return component[u] == component[v]; } // same connected component
+   // A row without routes to other nodes if false: the node is isolated or, with pruneComponents, cannot reach a destination
+   bool isRoutedSource(int src) const {
+       int c = component[src];
+       return componentSize[c] > 1 && (!pruneComponents || componentHasDestination[c]);
+   }
+
+   void setEngine(RouteEngine *engine); // takes ownership
+   const RouteEngine& getEngine() const { return *engine; }
+
+   DijkstraAllPairsOutput findAllShortestPaths() const; // computed by the engine
+   // Fills one row of an all-pairs table; backupNextHops may be nullptr. Rows of sources that are not
+   // routed only get the route of the source to itself.
+   void findShortestPathsFromSource(int src, uint16_t *distances, uint16_t *nextHops, uint16_t *backupNextHops) const;
+   // Whether the row of src, computed before the links in changedEdges were added or removed, can differ from a
+   // recomputation on the current graph (hop count metric only). wasRoutedSource is isRoutedSource(src) before the change.
+   bool isRouteRowAffected(int src, bool wasRoutedSource, const uint16_t *distances, const std::vector<std::pair<int, int>>& changedEdges) const;
+   // One column: route of every node to the nearest of the destinations, which nearestDestination receives
+   DijkstraAllPairsOutput findAllShortestPathsToDestination(const std::vector<int>& destIndices, std::vector<uint16_t>& nearestDestination) const;
+   // Whether an aircraft src forwards a packet for ground station dest along the route to the nearest ground station.
+   // Only if that station is dest itself: a packet never turns towards a station it is not addressed to, which would
+   // hand it to a ground station that has to send it back up.
+   static bool routesToNearestDestination(int src, int dest, const std::vector<bool>& isDestination, const std::vector<uint16_t>& nearestDestination) {
+       return dest < (int)isDestination.size() && isDestination[dest] && !isDestination[src] && nearestDestination[src] == dest;
+   }
+
+private:
+   ThreadPool *threadPool;
+   std::unique_ptr<RouteEngine> engine;
+   BitGraph graph;
+   WeightedGraph weights; // unused with HOP_COUNT
+   std::vector<int> component; // per node, the label of its connected component
+   std::vector<int> componentSize; // per label
+   std::vector<bool> componentHasDestination; // per label
+};
+
+#endif /* ROUTECALCULATOR_H_ */
@@ -0,0 +1,39 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "RouteEngine.h"
+#include "FloydWarshallRouteEngine.h"
+
+RouteEngine *RouteEngine::create(const std::string& name)
+{
+    if (name == "search")
+        return new SearchRouteEngine();
+    if (name == "floydWarshall")
+        return new FloydWarshallRouteEngine();
+    return nullptr;
+}
+
+DijkstraAllPairsOutput SearchRouteEngine::findAllShortestPaths(const RouteCalculator& routes) const
+{
+    int numNodes = routes.getGraph().size();
+    DijkstraAllPairsOutput result;
+    result.reset(numNodes, numNodes, routes.backupRoutes);
+
+    routes.getThreadPool()->parallelFor(numNodes, [&](int src) {
+        routes.findShortestPathsFromSource(src, result.distanceRow(src), result.nextHopRow(src), result.backupNextHopRow(src));
+    });
+    return result;
+}
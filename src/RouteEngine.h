@@ -0,0 +1,47 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ROUTEENGINE_H_
+#define ROUTEENGINE_H_
+
+#include <string>
+#include "RouteCalculator.h"
+
+// Algorithm behind RouteCalculator::findAllShortestPaths. Engines read the topology, link metric and
+// thread pool of the calculator; single-source searches of lazy and incremental updates are not affected.
+class RouteEngine {
+
+public:
+   virtual ~RouteEngine() {}
+   virtual const char *getName() const = 0;
+   virtual bool supportsLinkMetric(LinkMetric linkMetric) const = 0;
+   // Distances and next hops between all nodes of the current graph, and backup next hops if routes.backupRoutes is set
+   virtual DijkstraAllPairsOutput findAllShortestPaths(const RouteCalculator& routes) const = 0;
+
+   // Engine for a routeEngine parameter value, nullptr if the name is unknown
+   static RouteEngine *create(const std::string& name);
+};
+
+// One breadth-first search per source, or one bucket-queue Dijkstra per source for weighted links
+class SearchRouteEngine : public RouteEngine {
+
+public:
+   const char *getName() const override { return "search"; }
+   bool supportsLinkMetric(LinkMetric) const override { return true; }
+   DijkstraAllPairsOutput findAllShortestPaths(const RouteCalculator& routes) const override;
+};
+
+#endif /* ROUTEENGINE_H_ */
@@ -0,0 +1,137 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <cstring>
+#include "RouteTableSnapshot.h"
+
+bool RouteTableSnapshotWriter::open(const std::string& fileName)
+{
+    close();
+    file = fopen(fileName.c_str(), "wb");
+    if (!file)
+        return false;
+    RouteTableSnapshotFileHeader header;
+    memcpy(header.magic, ROUTE_TABLE_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = ROUTE_TABLE_SNAPSHOT_VERSION;
+    header.snapshotHeaderSize = sizeof(RouteTableSnapshotHeader);
+    append(&header, sizeof(header));
+    return true;
+}
+
+void RouteTableSnapshotWriter::write(double simTime, long routeEpoch, const std::vector<uint32_t>& addresses, const BitGraph& graph,
+        const std::vector<uint16_t>& nearestDestination, const DijkstraAllPairsOutput& toDestinations, const DijkstraAllPairsOutput *allPairs,
+        const std::vector<uint8_t> *computedRows)
+{
+    if (!file)
+        return;
+    int numNodes = addresses.size();
+    std::vector<uint16_t> linkSources, linkTargets;
+    std::vector<int> neighbors;
+    for (int u = 0; u < numNodes; ++u) {
+        graph.neighbors(u, neighbors);
+        for (int v : neighbors) {
+            if (v > u) {
+                linkSources.push_back(u);
+                linkTargets.push_back(v);
+            }
+        }
+    }
+    std::vector<uint16_t> destinationNextHops(numNodes), destinationDistances(numNodes);
+    for (int i = 0; i < numNodes; ++i) {
+        destinationNextHops[i] = toDestinations.nextHops[i];
+        destinationDistances[i] = toDestinations.distances[i];
+    }
+
+    RouteTableSnapshotHeader header = {};
+    header.simTime = simTime;
+    header.routeEpoch = routeEpoch;
+    header.numNodes = numNodes;
+    header.numLinks = linkSources.size();
+    if (allPairs)
+        header.flags |= ROUTE_SNAPSHOT_ALL_PAIRS | (allPairs->backupNextHops.empty() ? 0 : ROUTE_SNAPSHOT_BACKUPS);
+    append(&header, sizeof(header));
+    appendColumn(addresses.data(), numNodes * sizeof(uint32_t));
+    appendColumn(linkSources.data(), linkSources.size() * sizeof(uint16_t));
+    appendColumn(linkTargets.data(), linkTargets.size() * sizeof(uint16_t));
+    appendColumn(nearestDestination.data(), numNodes * sizeof(uint16_t));
+    appendColumn(destinationNextHops.data(), numNodes * sizeof(uint16_t));
+    appendColumn(destinationDistances.data(), numNodes * sizeof(uint16_t));
+    if (header.flags & ROUTE_SNAPSHOT_ALL_PAIRS) {
+        std::vector<uint8_t> allRows;
+        if (!computedRows) {
+            allRows.assign(numNodes, 1);
+            computedRows = &allRows;
+        }
+        appendColumn(computedRows->data(), numNodes * sizeof(uint8_t));
+        appendTable(allPairs->distances, numNodes, *computedRows);
+        appendTable(allPairs->nextHops, numNodes, *computedRows);
+        if (header.flags & ROUTE_SNAPSHOT_BACKUPS)
+            appendTable(allPairs->backupNextHops, numNodes, *computedRows);
+    }
+    if (buffer.size() >= FLUSH_SIZE)
+        flush();
+}
+
+void RouteTableSnapshotWriter::append(const void *data, size_t size)
+{
+    const char *bytes = (const char *)data;
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void RouteTableSnapshotWriter::appendColumn(const void *data, size_t size)
+{
+    append(data, size);
+    buffer.resize(buffer.size() + ((8 - size % 8) % 8), 0);
+}
+
+void RouteTableSnapshotWriter::appendTable(const std::vector<uint16_t>& table, int numNodes, const std::vector<uint8_t>& computedRows)
+{
+    size_t rowSize = numNodes * sizeof(uint16_t);
+    size_t start = buffer.size();
+    buffer.resize(start + numNodes * rowSize);
+    for (int src = 0; src < numNodes; ++src) {
+        uint16_t *row = (uint16_t *)(buffer.data() + start + src * rowSize);
+        if (computedRows[src])
+            memcpy(row, table.data() + (size_t)src * numNodes, rowSize);
+        else
+            std::fill(row, row + numNodes, UNREACHABLE_ROUTE);
+    }
+    buffer.resize(buffer.size() + ((8 - (numNodes * rowSize) % 8) % 8), 0);
+}
+
+void RouteTableSnapshotWriter::flush()
+{
+    if (flusher.joinable())
+        flusher.join();
+    flushing.swap(buffer);
+    buffer.clear();
+    flusher = std::thread([this]() {
+        fwrite(flushing.data(), 1, flushing.size(), file);
+    });
+}
+
+void RouteTableSnapshotWriter::close()
+{
+    if (!file)
+        return;
+    flush();
+    flusher.join();
+    fclose(file);
+    file = nullptr;
+    buffer.clear();
+    flushing.clear();
+}
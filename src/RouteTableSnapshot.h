@@ -0,0 +1,91 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef ROUTETABLESNAPSHOT_H_
+#define ROUTETABLESNAPSHOT_H_
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RouteCalculator.h"
+
+// Binary export of the topology and route tables of every route epoch, read by simulations/route_tables.py.
+// Native-endian, one column per field, every column padded with zeros to a multiple of 8 bytes:
+//
+//   RouteTableSnapshotFileHeader
+//   per epoch: RouteTableSnapshotHeader,
+//              uint32_t addresses[numNodes] (IPv4 as integers, 0 for other address types),
+//              uint16_t linkSources[numLinks], uint16_t linkTargets[numLinks] (source < target),
+//              uint16_t nearestDestination[numNodes], destinationNextHops[numNodes], destinationDistances[numNodes],
+//              with ROUTE_SNAPSHOT_ALL_PAIRS: uint8_t computedRows[numNodes],
+//                                             uint16_t distances[numNodes * numNodes], nextHops[numNodes * numNodes],
+//              with ROUTE_SNAPSHOT_BACKUPS: uint16_t backupNextHops[numNodes * numNodes]
+//
+// Node indices refer to addresses; UNREACHABLE_ROUTE marks missing entries as in DijkstraAllPairsOutput.
+// computedRows is 1 for the sources whose all-pairs row holds routes of this epoch. With lazyRouteComputation only
+// sources that forwarded a packet during the epoch have one; the rows of all other sources are written as UNREACHABLE_ROUTE.
+struct RouteTableSnapshotFileHeader {
+    char magic[8]; // ROUTE_TABLE_SNAPSHOT_MAGIC
+    uint32_t version;
+    uint32_t snapshotHeaderSize; // sizeof(RouteTableSnapshotHeader) of the writer
+};
+
+struct RouteTableSnapshotHeader {
+    double simTime; // s, start of the epoch
+    int64_t routeEpoch;
+    uint32_t numNodes;
+    uint32_t numLinks;
+    uint32_t flags; // ROUTE_SNAPSHOT_ALL_PAIRS, ROUTE_SNAPSHOT_BACKUPS
+    uint32_t reserved;
+};
+
+const char ROUTE_TABLE_SNAPSHOT_MAGIC[8] = { 'D', 'S', 'P', 'R', 'R', 'T', 'S', '\0' };
+const uint32_t ROUTE_TABLE_SNAPSHOT_VERSION = 2;
+const uint32_t ROUTE_SNAPSHOT_ALL_PAIRS = 1;
+const uint32_t ROUTE_SNAPSHOT_BACKUPS = 2;
+
+// Encodes snapshots into a memory buffer. Full buffers are written by a background thread while the
+// next one fills, so a route update only pays for copying its tables.
+class RouteTableSnapshotWriter {
+
+public:
+   static const size_t FLUSH_SIZE = 16 << 20;
+
+   ~RouteTableSnapshotWriter() { close(); }
+   bool open(const std::string& fileName); // false if the file cannot be created
+   bool isOpen() const { return file != nullptr; }
+   // allPairs may be nullptr; its backup next hops are written if it has them. computedRows (one entry per source,
+   // nullptr if all rows are valid) selects the rows of allPairs that belong to this epoch.
+   void write(double simTime, long routeEpoch, const std::vector<uint32_t>& addresses, const BitGraph& graph,
+           const std::vector<uint16_t>& nearestDestination, const DijkstraAllPairsOutput& toDestinations, const DijkstraAllPairsOutput *allPairs,
+           const std::vector<uint8_t> *computedRows = nullptr);
+   void close(); // writes out everything buffered
+
+private:
+   FILE *file = nullptr;
+   std::vector<char> buffer;
+   std::vector<char> flushing; // owned by flusher while it runs
+   std::thread flusher;
+
+   void append(const void *data, size_t size);
+   void appendColumn(const void *data, size_t size); // padded to 8 bytes
+   void appendTable(const std::vector<uint16_t>& table, int numNodes, const std::vector<uint8_t>& computedRows); // rows not computed as UNREACHABLE_ROUTE
+   void flush();
+};
+
+#endif /* ROUTETABLESNAPSHOT_H_ */
@@ -0,0 +1,113 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef SPATIALGRID_H_
+#define SPATIALGRID_H_
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+// Uniform grid (cell list) over a set of points with public x, y and z members.
+// With the cell size set to the communication range, every pair of points within
+// range lies in the same or in adjacent cells, so only those have to be compared.
+template <typename Point>
+class SpatialGrid {
+
+public:
+   SpatialGrid(const std::vector<Point>& points, double cellSize)
+       : points(points), cellSize(cellSize > 0 ? cellSize : 1.0)
+   {
+       int numPoints = points.size();
+       std::vector<std::pair<uint64_t, int>> keyed(numPoints);
+       cellOfPoint.resize(numPoints);
+       for (int i = 0; i < numPoints; ++i) {
+           cellOfPoint[i] = cellIndex(points[i]);
+           keyed[i] = { cellKey(cellOfPoint[i]), i };
+       }
+       // Sorting by cell key keeps the members of a cell contiguous and in ascending index order
+       std::sort(keyed.begin(), keyed.end());
+       sortedPoints.resize(numPoints);
+       for (int k = 0; k < numPoints; ++k) {
+           sortedPoints[k] = keyed[k].second;
+           if (k == 0 || keyed[k].first != keyed[k - 1].first)
+               cells[keyed[k].first] = { k, k };
+           cells[keyed[k].first].second = k + 1;
+       }
+   }
+
+   // Calls visit(i, j) once for every pair i < j located in the same or in adjacent cells.
+   template <typename Visitor>
+   void forEachCandidatePair(Visitor visit) const
+   {
+       int numPoints = points.size();
+       for (int i = 0; i < numPoints; ++i) {
+           forEachCandidate(i, [&](int j) {
+               if (j > i)
+                   visit(i, j);
+           });
+       }
+   }
+
+   // Calls visit(j) for every point j != i located in the same or in an adjacent cell of point i.
+   template <typename Visitor>
+   void forEachCandidate(int i, Visitor visit) const
+   {
+       const Cell& c = cellOfPoint[i];
+       for (int dx = -1; dx <= 1; ++dx) {
+           for (int dy = -1; dy <= 1; ++dy) {
+               for (int dz = -1; dz <= 1; ++dz) {
+                   auto it = cells.find(cellKey({ c.x + dx, c.y + dy, c.z + dz }));
+                   if (it == cells.end())
+                       continue;
+                   for (int k = it->second.first; k < it->second.second; ++k) {
+                       int j = sortedPoints[k];
+                       if (j != i)
+                           visit(j);
+                   }
+               }
+           }
+       }
+   }
+
+private:
+   struct Cell {
+       int64_t x, y, z;
+   };
+
+   const std::vector<Point>& points;
+   double cellSize;
+   std::vector<Cell> cellOfPoint;
+   std::vector<int> sortedPoints;
+   std::unordered_map<uint64_t, std::pair<int, int>> cells; // cell key -> [begin, end) in sortedPoints
+
+   Cell cellIndex(const Point& p) const
+   {
+       return { (int64_t)std::floor(p.x / cellSize), (int64_t)std::floor(p.y / cellSize), (int64_t)std::floor(p.z / cellSize) };
+   }
+
+   // Packs 21 bits per axis. Cells that alias after wrap-around only add candidates, never hide one.
+   static uint64_t cellKey(const Cell& c)
+   {
+       const uint64_t mask = (1ULL << 21) - 1;
+       return (((uint64_t)c.x & mask) << 42) | (((uint64_t)c.y & mask) << 21) | ((uint64_t)c.z & mask);
+   }
+};
+
+#endif /* SPATIALGRID_H_ */
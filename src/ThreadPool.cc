@@ -0,0 +1,91 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int numThreads) : nextIndex(0)
+{
+    for (int i = 1; i < numThreads; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& body)
+{
+    if (workers.empty() || count <= 1) {
+        for (int i = 0; i < count; ++i)
+            body(i);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentBody = &body;
+        currentCount = count;
+        // A few chunks per thread balance uneven rows without much contention on nextIndex
+        chunkSize = std::max(1, count / (size() * 8));
+        nextIndex = 0;
+        busyWorkers = workers.size();
+        ++generation;
+    }
+    workAvailable.notify_all();
+    runChunks();
+    std::unique_lock<std::mutex> lock(mutex);
+    workDone.wait(lock, [this] { return busyWorkers == 0; });
+    currentBody = nullptr;
+}
+
+void ThreadPool::workerLoop()
+{
+    long seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            workAvailable.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping)
+                return;
+            seenGeneration = generation;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busyWorkers;
+        }
+        workDone.notify_one();
+    }
+}
+
+void ThreadPool::runChunks()
+{
+    while (true) {
+        int begin = nextIndex.fetch_add(chunkSize);
+        if (begin >= currentCount)
+            return;
+        int end = std::min(begin + chunkSize, currentCount);
+        for (int i = begin; i < end; ++i)
+            (*currentBody)(i);
+    }
+}
@@ -0,0 +1,57 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. The calling thread takes part in
+// every loop, so a pool of size 1 has no workers and runs loops inline.
+class ThreadPool {
+
+public:
+   explicit ThreadPool(int numThreads);
+   ~ThreadPool();
+   int size() const { return workers.size() + 1; }
+
+   // Runs body(i) for every i in [0, count) and returns once all calls have finished.
+   // Indices are handed out in chunks, so body must only write state owned by index i.
+   void parallelFor(int count, const std::function<void(int)>& body);
+
+private:
+   std::vector<std::thread> workers;
+   std::mutex mutex;
+   std::condition_variable workAvailable;
+   std::condition_variable workDone;
+   const std::function<void(int)> *currentBody = nullptr;
+   int currentCount = 0;
+   int chunkSize = 1;
+   std::atomic<int> nextIndex;
+   long generation = 0;
+   int busyWorkers = 0;
+   bool stopping = false;
+
+   void workerLoop();
+   void runChunks();
+};
+
+#endif /* THREADPOOL_H_ */
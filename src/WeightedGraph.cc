@@ -0,0 +1,99 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#include <climits>
+#include <algorithm>
+#include "WeightedGraph.h"
+
+void WeightedGraph::assign(const AdjacencyLists& links)
+{
+    numNodes = links.size();
+    offsets = links.offsets;
+    targets = links.targets;
+    weights = links.weights;
+    maxWeight = 1;
+    for (uint16_t w : weights)
+        maxWeight = std::max(maxWeight, (int)w);
+}
+
+void WeightedGraph::search(int root, std::vector<int>& hops, std::vector<int>& previous, std::vector<int> *firstHop) const
+{
+    if (firstHop)
+        firstHop->assign(numNodes, -1);
+    expand(std::vector<int>(1, root), hops, previous, firstHop, root);
+}
+
+void WeightedGraph::searchNearest(const std::vector<int>& roots, std::vector<int>& hops, std::vector<int>& previous, std::vector<int>& nearestRoot) const
+{
+    nearestRoot.assign(numNodes, -1);
+    std::vector<int> sortedRoots;
+    for (int root : roots) {
+        if (root >= 0 && root < numNodes)
+            sortedRoots.push_back(root);
+    }
+    std::sort(sortedRoots.begin(), sortedRoots.end());
+    sortedRoots.erase(std::unique(sortedRoots.begin(), sortedRoots.end()), sortedRoots.end());
+    expand(sortedRoots, hops, previous, &nearestRoot, -1);
+}
+
+void WeightedGraph::expand(const std::vector<int>& roots, std::vector<int>& hops, std::vector<int>& previous, std::vector<int> *label, int root) const
+{
+    hops.assign(numNodes, INT_MAX);
+    previous.assign(numNodes, -1);
+    std::vector<long> cost(numNodes, LONG_MAX);
+    std::vector<bool> settled(numNodes, false);
+    // Links are at most maxWeight long, so all tentative costs lie within maxWeight + 1 consecutive buckets
+    int numBuckets = maxWeight + 1;
+    std::vector<std::vector<int>> buckets(numBuckets);
+    long queued = 0;
+    for (int r : roots) {
+        cost[r] = 0;
+        hops[r] = 0;
+        if (label)
+            (*label)[r] = r;
+        buckets[0].push_back(r);
+        ++queued;
+    }
+
+    for (long c = 0; queued > 0; ++c) {
+        std::vector<int>& bucket = buckets[c % numBuckets];
+        // Every link has weight of at least one, so relaxations never add to the bucket being scanned
+        for (int u : bucket) {
+            --queued;
+            if (settled[u] || cost[u] != c)
+                continue; // superseded entry
+            settled[u] = true;
+            for (int k = offsets[u]; k < offsets[u + 1]; ++k) {
+                int v = targets[k];
+                if (settled[v])
+                    continue;
+                long newCost = c + weights[k];
+                if (newCost < cost[v] || (newCost == cost[v] && hops[u] + 1 < hops[v])) {
+                    if (newCost < cost[v]) {
+                        cost[v] = newCost;
+                        buckets[newCost % numBuckets].push_back(v);
+                        ++queued;
+                    }
+                    hops[v] = hops[u] + 1;
+                    previous[v] = u;
+                    if (label)
+                        (*label)[v] = (u == root) ? v : (*label)[u];
+                }
+            }
+        }
+        bucket.clear();
+    }
+}
@@ -0,0 +1,53 @@
+// The LDACS Dijkstra implements the Dijkstra's shortest path routing algorithm.
+// Copyright (C) 2024  Musab Ahmed, Sohini Maji, Institute of Communication Networks, Hamburg University of Technology, Hamburg, Germany
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+#ifndef WEIGHTEDGRAPH_H_
+#define WEIGHTEDGRAPH_H_
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "AdjacencyLists.h"
+
+// Graph with small positive integer link weights in compressed sparse rows.
+// Searches use Dial's algorithm: a circular array of maxWeight + 1 buckets indexed by path cost
+// replaces the binary heap, so each search costs O(links + largest path cost).
+class WeightedGraph {
+
+public:
+   void assign(const AdjacencyLists& links);
+   int size() const { return numNodes; }
+   size_t memoryBytes() const { return offsets.capacity() * sizeof(int) + targets.capacity() * sizeof(int) + weights.capacity() * sizeof(uint16_t); }
+
+   // Minimum-weight paths from root. Fills the same fields as BitGraph::search, except that hops holds the
+   // hop count of the chosen path (INT_MAX if unreachable). Among paths of equal weight the one with fewer hops wins.
+   void search(int root, std::vector<int>& hops, std::vector<int>& previous, std::vector<int> *firstHop = nullptr) const;
+
+   // Minimum-weight paths towards the nearest of roots, as BitGraph::searchNearest
+   void searchNearest(const std::vector<int>& roots, std::vector<int>& hops, std::vector<int>& previous, std::vector<int>& nearestRoot) const;
+
+private:
+   int numNodes = 0;
+   int maxWeight = 1;
+   std::vector<int> offsets; // links of u are [offsets[u], offsets[u + 1])
+   std::vector<int> targets;
+   std::vector<uint16_t> weights;
+
+   // Dial's algorithm from the given roots at cost 0; labels propagate as in BitGraph::expand
+   void expand(const std::vector<int>& roots, std::vector<int>& hops, std::vector<int>& previous, std::vector<int> *label, int root) const;
+};
+
+#endif /* WEIGHTEDGRAPH_H_ */